@@ -1,4 +1,6 @@
 #include "arguments.h"
+#include "step_profile.h"
+#include "world.h"
 
 const char doc[] = "Welcome to the simulator for the 2D Colatz Quasi Cellular "
                    "Automaton.\nRefer to the Github repository for more info: "
@@ -65,6 +67,9 @@ void usagePage() {
 
 void helpPage() {
   printf("Usage ./%s [OPTION...]\n", simcqca_PROG_NAME_EXEC);
+  printf("   or ./%s batch [OPTION...] to simulate every parity vector of a "
+         "given length, see ./%s batch --help\n",
+         simcqca_PROG_NAME_EXEC, simcqca_PROG_NAME_EXEC);
   printf("%s\n\n", doc);
   int iOption = 0;
   while (iOption < options.size()) {
@@ -86,12 +91,6 @@ void parseArguments(int argc, char *argv[], Arguments &arguments) {
   if (input.cmdOptionExists(getShortOptionStr(options[0].shortOption)) ||
       input.cmdOptionExists(getLongOptionStr(options[0].longOption))) {
     arguments.isSequential = true;
-    printf(
-        "The sequential simulation of the CQCA is not implemented yet. Refer "
-        "to old project `nanopipes` (extremely CPU intensive and not well "
-        "documented: https://github.com/tcosmo/nanopipes) "
-        "if you want to see what it looks like. Abort. Sorry :(\n");
-    exit(0);
   }
 
   bool atLeastOne = false;
@@ -135,6 +134,206 @@ void parseArguments(int argc, char *argv[], Arguments &arguments) {
     arguments.cycleBoth = true;
   }
 
+  // Snapshots
+  if (input.cmdOptionExists(getShortOptionStr(options[12].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[12].longOption))) {
+    arguments.saveSnapshotPath =
+        orStr(input.getCmdOption(getShortOptionStr(options[12].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[12].longOption)));
+    if (arguments.saveSnapshotPath.empty()) {
+      printf("The `--%s` option expects a file name. Abort.\n",
+             options[12].longOption);
+      exit(0);
+    }
+  }
+  if (input.cmdOptionExists(getShortOptionStr(options[13].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[13].longOption))) {
+    if (atLeastOne) {
+      printf("The `--%s` option cannot be combined with an input mode, the "
+             "snapshot holds the input. Abort.\n",
+             options[13].longOption);
+      exit(0);
+    }
+    arguments.loadSnapshotPath =
+        orStr(input.getCmdOption(getShortOptionStr(options[13].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[13].longOption)));
+    if (arguments.loadSnapshotPath.empty()) {
+      printf("The `--%s` option expects a file name. Abort.\n",
+             options[13].longOption);
+      exit(0);
+    }
+    // The options below are checked against the mode of the snapshot
+    World::readSnapshotInput(arguments.loadSnapshotPath, arguments);
+    atLeastOne = true;
+  }
+
+  // Fast engines
+  if (input.cmdOptionExists(getShortOptionStr(options[8].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[8].longOption))) {
+    if (arguments.inputType != LINE && arguments.inputType != COL) {
+      printf("The `--%s` option is only valid in row or col mode. Abort.\n",
+             options[8].longOption);
+      exit(0);
+    }
+    if (arguments.isSequential) {
+      printf("The `--%s` option cannot be combined with sequential "
+             "simulation. Abort.\n",
+             options[8].longOption);
+      exit(0);
+    }
+    arguments.isFastEngineEnabled = true;
+  }
+
+  // Threads
+  if (input.cmdOptionExists(getShortOptionStr(options[9].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[9].longOption))) {
+    const std::string &nbThreadsStr =
+        orStr(input.getCmdOption(getShortOptionStr(options[9].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[9].longOption)));
+    arguments.nbThreads = atoi(nbThreadsStr.c_str());
+    if (arguments.nbThreads < 1) {
+      printf("The `--%s` option expects a positive number of threads. "
+             "Abort.\n",
+             options[9].longOption);
+      exit(0);
+    }
+  }
+
+  // Streaming
+  if (input.cmdOptionExists(getShortOptionStr(options[10].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[10].longOption))) {
+    if (arguments.inputType == CYCLE) {
+      printf("The `--%s` option is not available in cycle mode. Abort.\n",
+             options[10].longOption);
+      exit(0);
+    }
+    const std::string &marginStr =
+        orStr(input.getCmdOption(getShortOptionStr(options[10].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[10].longOption)));
+    arguments.streamingMargin = atoi(marginStr.c_str());
+    if (marginStr.empty() || arguments.streamingMargin < 0) {
+      printf("The `--%s` option expects a non negative margin. Abort.\n",
+             options[10].longOption);
+      exit(0);
+    }
+  }
+
+  // Spill
+  if (input.cmdOptionExists(getShortOptionStr(options[11].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[11].longOption))) {
+    if (arguments.streamingMargin < 0) {
+      printf("The `--%s` option is only valid in streaming mode. Abort.\n",
+             options[11].longOption);
+      exit(0);
+    }
+    arguments.spillPath =
+        orStr(input.getCmdOption(getShortOptionStr(options[11].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[11].longOption)));
+    if (arguments.spillPath.empty()) {
+      printf("The `--%s` option expects a file name. Abort.\n",
+             options[11].longOption);
+      exit(0);
+    }
+  }
+
+  // Out-of-core cells
+  if (input.cmdOptionExists(getShortOptionStr(options[14].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[14].longOption))) {
+    arguments.outOfCorePath =
+        orStr(input.getCmdOption(getShortOptionStr(options[14].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[14].longOption)));
+    if (arguments.outOfCorePath.empty()) {
+      printf("The `--%s` option expects a file name. Abort.\n",
+             options[14].longOption);
+      exit(0);
+    }
+  }
+  if (input.cmdOptionExists(getShortOptionStr(options[15].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[15].longOption))) {
+    if (arguments.outOfCorePath.empty()) {
+      printf("The `--%s` option is only valid with `--%s`. Abort.\n",
+             options[15].longOption, options[14].longOption);
+      exit(0);
+    }
+    const std::string &budgetStr =
+        orStr(input.getCmdOption(getShortOptionStr(options[15].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[15].longOption)));
+    arguments.residentBudgetMB = atoi(budgetStr.c_str());
+    if (arguments.residentBudgetMB < 1) {
+      printf("The `--%s` option expects a positive number of megabytes. "
+             "Abort.\n",
+             options[15].longOption);
+      exit(0);
+    }
+  }
+
+  // Headless
+  if (input.cmdOptionExists(getShortOptionStr(options[16].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[16].longOption))) {
+    arguments.isHeadless = true;
+  }
+  if (input.cmdOptionExists(getShortOptionStr(options[17].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[17].longOption))) {
+    const std::string &nbStepsStr =
+        orStr(input.getCmdOption(getShortOptionStr(options[17].shortOption)),
+              input.getCmdOption(getLongOptionStr(options[17].longOption)));
+    arguments.nbHeadlessSteps = atoi(nbStepsStr.c_str());
+    if (nbStepsStr.empty() || arguments.nbHeadlessSteps < 0) {
+      printf("The `--%s` option expects a non negative number of steps. "
+             "Abort.\n",
+             options[17].longOption);
+      exit(0);
+    }
+  }
+  if (input.cmdOptionExists(getShortOptionStr(options[18].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[18].longOption))) {
+    if (arguments.inputType != CYCLE) {
+      if (arguments.loadSnapshotPath.empty())
+        printf("The `--%s` option is only valid in cycle mode. Abort.\n",
+               options[18].longOption);
+      else
+        printf("The `--%s` option needs cycle mode, snapshot `%s` is not in "
+               "cycle mode. Abort.\n",
+               options[18].longOption, arguments.loadSnapshotPath.c_str());
+      exit(0);
+    }
+    arguments.isUntilCycle = true;
+  }
+  if (input.cmdOptionExists(getShortOptionStr(options[19].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[19].longOption))) {
+    if (arguments.inputType != BORDER) {
+      if (arguments.loadSnapshotPath.empty())
+        printf("The `--%s` option is only valid in border mode. Abort.\n",
+               options[19].longOption);
+      else
+        printf("The `--%s` option needs border mode, snapshot `%s` is not in "
+               "border mode. Abort.\n",
+               options[19].longOption, arguments.loadSnapshotPath.c_str());
+      exit(0);
+    }
+    arguments.isUntilDone = true;
+  }
+  bool isHeadlessRunGiven = arguments.nbHeadlessSteps >= 0 ||
+                            arguments.isUntilCycle || arguments.isUntilDone;
+  if (arguments.isHeadless != isHeadlessRunGiven) {
+    printf("The `--%s` option goes with `--%s`, `--%s` or `--%s`. Abort.\n",
+           options[16].longOption, options[17].longOption,
+           options[18].longOption, options[19].longOption);
+    exit(0);
+  }
+
+  // Profiling
+  if (input.cmdOptionExists(getShortOptionStr(options[20].shortOption)) ||
+      input.cmdOptionExists(getLongOptionStr(options[20].longOption))) {
+    if (!IS_PROFILING_COMPILED) {
+      printf("The `--%s` option needs a build with SIMCQCA_PROFILING. "
+             "Abort.\n",
+             options[20].longOption);
+      exit(0);
+    }
+    arguments.isProfiling = true;
+  }
+
   if (input.cmdOptionExists("-V") || input.cmdOptionExists("--version")) {
     printf("%s\n", argp_program_version);
     exit(0);
@@ -3,10 +3,13 @@
 #include "config.h"
 #include <algorithm>
 #include <string>
+#include <thread>
 #include <vector>
 
 enum InputType { NONE = 0, LINE, COL, BORDER, CYCLE };
 
+#define DEFAULT_RESIDENT_BUDGET_MB 1024
+
 // https://stackoverflow.com/questions/865668/how-to-parse-command-line-arguments-in-c
 class InputParser {
 public:
@@ -43,8 +46,8 @@ struct InputOption {
 
 static std::vector<InputOption> options = {
     {"seq", 's', NULL,
-     "Not implemented yet: runs sequential simulation instead of CA-style "
-     "simulation"},
+     "Runs sequential simulation instead of CA-style simulation: cells are "
+     "updated one at a time from a worklist"},
     {"row", 'r', "INPUT BASE 2", "Inputs a binary row to the process"},
     {"col", 'c', "INPUT BASE 3",
      "Inputs a ternary column to the process. Base 3 -> base3' conversion is "
@@ -63,6 +66,46 @@ static std::vector<InputOption> options = {
     {"cycle-both", 'j', NULL,
      "Combine this option with cycle mode to run the construction per row and "
      "per column at the same time."},
+    {"fast", 'f', NULL,
+     "Combine this option with row or col mode to compute each row or column "
+     "at once instead of cell by cell. One step computes one row or column."},
+    {"threads", 'p', "NB THREADS",
+     "Number of threads used to find the updates of a simulation step, "
+     "defaults to the number of cores. Results do not depend on it."},
+    {"stream", 'w', "MARGIN",
+     "Streaming mode: only keeps the cells within MARGIN cells of the edge of "
+     "the computation, fully defined regions further away are evicted. Not "
+     "available in cycle mode."},
+    {"spill", 'o', "FILE",
+     "Combine this option with streaming mode to write the evicted cells to "
+     "FILE, one `x y bit carry` line per cell."},
+    {"save-snapshot", 'x', "FILE",
+     "Binary snapshot of the world written to FILE when pressing S."},
+    {"load-snapshot", 'l', "FILE",
+     "Resumes the simulation from a snapshot written with `--save-snapshot`. "
+     "The snapshot holds the input, no mode option should be given."},
+    {"out-of-core", 'm', "FILE",
+     "Keeps the cells in a memory mapped scratch file FILE instead of memory, "
+     "for worlds larger than the physical memory. FILE is deleted on exit."},
+    {"resident-budget", 'g', "MB",
+     "Combine this option with `--out-of-core`: megabytes of cells kept in "
+     "memory, the others are paged out to the file. Defaults to 1024."},
+    {"headless", 'e', NULL,
+     "Runs the simulation without opening a window, combine with `--steps`, "
+     "`--until-cycle` or `--until-done`. Prints what the A and P keys "
+     "print, and saves a snapshot if `--save-snapshot` is given."},
+    {"steps", 'n', "NB STEPS",
+     "Combine this option with `--headless`: number of simulation steps, or "
+     "at most that many with `--until-cycle` or `--until-done`"},
+    {"until-cycle", 'k', NULL,
+     "Combine this option with `--headless` in cycle mode: runs until the "
+     "cycle is detected"},
+    {"until-done", 'd', NULL,
+     "Combine this option with `--headless` in border mode: runs until the "
+     "computation is done"},
+    {"profile", 'q', NULL,
+     "Times each phase of the simulation steps and counts their updates, "
+     "printed with the A key and by `--headless`. ALT + A toggles it."},
 
     // Default options
     {"help", 'h', NULL, "Give this help list"},
@@ -76,10 +119,26 @@ struct Arguments {
   bool constructCycleInLine;
   bool isTikzEnabled;
   bool cycleBoth;
+  bool isFastEngineEnabled;
+  int nbThreads;
+  int streamingMargin; // -1 when not streaming
+  std::string spillPath;
+  std::string saveSnapshotPath;
+  std::string loadSnapshotPath;
+  std::string outOfCorePath; // Empty when cells are in memory
+  int residentBudgetMB;
+  bool isHeadless;
+  int nbHeadlessSteps; // -1 when not given
+  bool isUntilCycle, isUntilDone;
+  bool isProfiling;
 
   Arguments()
       : isSequential(false), inputType(NONE), constructCycleInLine(false),
-        isTikzEnabled(false), cycleBoth(false) {}
+        isTikzEnabled(false), cycleBoth(false), isFastEngineEnabled(false),
+        nbThreads(std::thread::hardware_concurrency()), streamingMargin(-1),
+        residentBudgetMB(DEFAULT_RESIDENT_BUDGET_MB), isHeadless(false),
+        nbHeadlessSteps(-1), isUntilCycle(false), isUntilDone(false),
+        isProfiling(false) {}
 };
 
 void parseArguments(int argc, char *argv[], Arguments &arguments);
\ No newline at end of file
@@ -0,0 +1,385 @@
+/**
+ * Headless sweep over every parity vector of a given length, in border or
+ * cycle mode, see `batch.h`. Each worker thread reuses its own world.
+ *
+ * The parity vector of index i has i's bits, most significant first. Its
+ * results are written as soon as they are known, in CSV or in binary: a
+ * `BatchHeader` then, for each parity vector, a `BatchRecord` followed by
+ * the row then the column, one byte per digit, padded to the next 8 bytes
+ * boundary. Numbers are stored in the byte order of the machine which wrote
+ * them, the header records it.
+ */
+
+#include "batch.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+static const char BATCH_MAGIC[8] = "SIMCQCB";
+static const uint32_t BATCH_VERSION = 1;
+static const uint32_t BATCH_BYTE_ORDER = 0x01020304;
+
+struct BatchHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  int32_t inputType;
+  int32_t length;
+  int32_t maxSteps;
+  uint32_t padding;
+};
+
+struct BatchRecord {
+  uint64_t parityVector; // Bits, the first one is the most significant
+  int64_t periodLength; // Cycle mode, -1 if not detected
+  uint64_t nbCells;
+  uint64_t timeMicroseconds;
+  uint32_t nbSteps;
+  uint8_t isResolved;
+  uint8_t padding[3];
+  uint32_t rowSize; // Border and cycle mode, most significant bit first
+  uint32_t colSize; // Border mode, most significant trit first
+};
+
+WorkStealingRanges::WorkStealingRanges(uint64_t nbTasks, int nbWorkers) {
+  for (int iWorker = 0; iWorker < nbWorkers; iWorker += 1) {
+    ranges.push_back(std::unique_ptr<Range>(new Range));
+    ranges.back()->begin = nbTasks * iWorker / nbWorkers;
+    ranges.back()->end = nbTasks * (iWorker + 1) / nbWorkers;
+  }
+}
+
+bool WorkStealingRanges::pop(int iWorker, uint64_t &iTask) {
+  {
+    Range &own = *ranges[iWorker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (own.begin < own.end) {
+      iTask = own.begin;
+      own.begin += 1;
+      return true;
+    }
+  }
+  return steal(iWorker, iTask);
+}
+
+bool WorkStealingRanges::steal(int iWorker, uint64_t &iTask) {
+  /**
+   * Sizes are read without locking to choose the victim, it is locked to
+   * actually steal and another one is chosen if it was emptied meanwhile.
+   * The own range is empty: no one steals from it while it is refilled.
+   */
+  int nbRanges = static_cast<int>(ranges.size());
+  while (true) {
+    int iVictim = -1;
+    uint64_t largestSize = 0;
+    for (int iRange = 0; iRange < nbRanges; iRange += 1) {
+      Range &range = *ranges[iRange];
+      std::lock_guard<std::mutex> lock(range.mutex);
+      if (range.end - range.begin > largestSize) {
+        largestSize = range.end - range.begin;
+        iVictim = iRange;
+      }
+    }
+    if (iVictim == -1)
+      return false;
+
+    uint64_t stolenBegin, stolenEnd;
+    {
+      Range &victim = *ranges[iVictim];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (victim.begin == victim.end)
+        continue;
+      stolenBegin = victim.begin + (victim.end - victim.begin) / 2;
+      stolenEnd = victim.end;
+      victim.end = stolenBegin;
+    }
+    Range &own = *ranges[iWorker];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    iTask = stolenBegin;
+    own.begin = stolenBegin + 1;
+    own.end = stolenEnd;
+    return true;
+  }
+}
+
+class BatchWriter {
+  /***
+   * Shared by the workers, which write their results by batches.
+   */
+public:
+  BatchWriter(FILE *file, const BatchArguments &arguments)
+      : file(file), isBinary(arguments.isBinary),
+        isBorder(arguments.inputType == BORDER) {
+    if (isBinary) {
+      BatchHeader header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, BATCH_MAGIC, sizeof(BATCH_MAGIC));
+      header.version = BATCH_VERSION;
+      header.byteOrder = BATCH_BYTE_ORDER;
+      header.inputType = arguments.inputType;
+      header.length = arguments.length;
+      header.maxSteps = arguments.maxSteps;
+      fwrite(&header, sizeof(header), 1, file);
+    } else if (isBorder)
+      fprintf(file, "parity_vector,is_done,row,col,nb_cells,nb_steps,"
+                    "time_us\n");
+    else
+      fprintf(file, "parity_vector,is_detected,row,period_length,nb_cells,"
+                    "nb_steps,time_us\n");
+  }
+
+  void write(const std::vector<ParityVectorResult> &results) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const ParityVectorResult &result : results)
+      if (isBinary)
+        writeBinary(result);
+      else
+        writeCsv(result);
+  }
+
+private:
+  void writeCsv(const ParityVectorResult &result) {
+    fprintf(file, "%s,%d,%s,", result.parityVector.c_str(), result.isResolved,
+            result.row.c_str());
+    if (isBorder)
+      fprintf(file, "%s,", result.col.c_str());
+    else
+      fprintf(file, "%lld,", static_cast<long long>(result.periodLength));
+    fprintf(file, "%zu,%d,%llu\n", result.nbCells, result.nbSteps,
+            static_cast<unsigned long long>(result.timeMicroseconds));
+  }
+
+  void writeBinary(const ParityVectorResult &result) {
+    static const char padding[8] = {0};
+    BatchRecord record;
+    memset(&record, 0, sizeof(record));
+    for (char parityBit : result.parityVector)
+      record.parityVector = 2 * record.parityVector + (parityBit - '0');
+    record.periodLength = result.periodLength;
+    record.nbCells = result.nbCells;
+    record.timeMicroseconds = result.timeMicroseconds;
+    record.nbSteps = result.nbSteps;
+    record.isResolved = result.isResolved;
+    record.rowSize = result.row.size();
+    record.colSize = result.col.size();
+    fwrite(&record, sizeof(record), 1, file);
+
+    std::string digits = result.row + result.col;
+    for (char &digit : digits)
+      digit -= '0';
+    fwrite(digits.data(), 1, digits.size(), file);
+    if (digits.size() % 8 != 0)
+      fwrite(padding, 1, 8 - digits.size() % 8, file);
+  }
+
+  FILE *file;
+  bool isBinary;
+  bool isBorder;
+  std::mutex mutex;
+};
+
+static uint64_t runAll(const BatchArguments &arguments, BatchWriter &writer,
+                       uint64_t &nbParityVectors, int &nbWorkers) {
+  nbParityVectors = static_cast<uint64_t>(1) << arguments.length;
+  nbWorkers = static_cast<int>(
+      std::min(static_cast<uint64_t>(arguments.nbThreads), nbParityVectors));
+  WorkStealingRanges tasks(nbParityVectors, nbWorkers);
+  std::vector<uint64_t> nbUnresolved(nbWorkers, 0);
+
+  auto work = [&](int iWorker) {
+    World world(false, arguments.inputType, std::string(arguments.length, '0'),
+                arguments.inputType == CYCLE, false, false);
+    std::vector<ParityVectorResult> results;
+    ParityVectorResult result;
+    std::string parityVector(arguments.length, '0');
+    while (tasks.pop(iWorker, result.index)) {
+      for (int iBit = 0; iBit < arguments.length; iBit += 1)
+        parityVector[arguments.length - 1 - iBit] =
+            '0' + ((result.index >> iBit) & 1);
+      world.setInput(parityVector);
+      simulateUntilResolved(world, arguments.maxSteps, result);
+      nbUnresolved[iWorker] += !result.isResolved;
+      results.push_back(result);
+      if (results.size() == BATCH_RESULTS_PER_FLUSH) {
+        writer.write(results);
+        results.clear();
+      }
+    }
+    writer.write(results);
+  };
+  std::vector<std::thread> workers;
+  for (int iWorker = 1; iWorker < nbWorkers; iWorker += 1)
+    workers.push_back(std::thread(work, iWorker));
+  work(0);
+  for (std::thread &worker : workers)
+    worker.join();
+
+  uint64_t nbTotalUnresolved = 0;
+  for (uint64_t nbWorkerUnresolved : nbUnresolved)
+    nbTotalUnresolved += nbWorkerUnresolved;
+  return nbTotalUnresolved;
+}
+
+static uint64_t runRotations(const BatchArguments &arguments,
+                             BatchWriter &writer, uint64_t &nbParityVectors,
+                             int &nbWorkers) {
+  World world(false, arguments.inputType, arguments.rotationsOf,
+              arguments.inputType == CYCLE, false, false);
+  RotationSweep rotations(world, arguments.nbThreads);
+  std::vector<ParityVectorResult> results = rotations.sweep(arguments.maxSteps);
+  writer.write(results);
+
+  nbParityVectors = results.size();
+  nbWorkers = MIN(arguments.nbThreads, rotations.getNbRotations());
+  uint64_t nbUnresolved = 0;
+  for (const ParityVectorResult &result : results)
+    nbUnresolved += !result.isResolved;
+  return nbUnresolved;
+}
+
+void runBatch(const BatchArguments &arguments) {
+  FILE *file = stdout;
+  if (!arguments.outputPath.empty()) {
+    file = fopen(arguments.outputPath.c_str(), arguments.isBinary ? "wb" : "w");
+    if (file == NULL) {
+      printf("Could not open `%s` to write the results. Abort.\n",
+             arguments.outputPath.c_str());
+      exit(0);
+    }
+  }
+  // Summary on the standard error when results are on the standard output
+  FILE *summaryFile = file == stdout ? stderr : stdout;
+
+  BatchWriter writer(file, arguments);
+  uint64_t nbParityVectors, nbUnresolved = 0;
+  int nbWorkers;
+  auto start = std::chrono::steady_clock::now();
+  if (!arguments.rotationsOf.empty())
+    nbUnresolved = runRotations(arguments, writer, nbParityVectors, nbWorkers);
+  else
+    nbUnresolved = runAll(arguments, writer, nbParityVectors, nbWorkers);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  if (file != stdout && fclose(file) != 0) {
+    printf("Could not write the results to `%s`. Abort.\n",
+           arguments.outputPath.c_str());
+    exit(0);
+  }
+  fprintf(summaryFile,
+          "Simulated %llu parity vectors of length %d in %.2fs on %d "
+          "threads, %llu not resolved within %d steps.\n",
+          static_cast<unsigned long long>(nbParityVectors), arguments.length,
+          seconds, nbWorkers, static_cast<unsigned long long>(nbUnresolved),
+          arguments.maxSteps);
+}
+
+static bool hasBatchOption(const InputParser &input, int iOption) {
+  std::string shortStr = "-";
+  shortStr.push_back(batchOptions[iOption].shortOption);
+  return input.cmdOptionExists(shortStr) ||
+         input.cmdOptionExists(std::string("--") +
+                               batchOptions[iOption].longOption);
+}
+
+static std::string getBatchOption(const InputParser &input, int iOption) {
+  std::string shortStr = "-";
+  shortStr.push_back(batchOptions[iOption].shortOption);
+  const std::string &shortValue = input.getCmdOption(shortStr);
+  if (!shortValue.empty())
+    return shortValue;
+  return input.getCmdOption(std::string("--") +
+                            batchOptions[iOption].longOption);
+}
+
+static void batchHelpPage() {
+  printf("Usage ./%s batch [OPTION...]\n", simcqca_PROG_NAME_EXEC);
+  printf("Simulates every parity vector of a given length without the "
+         "graphic interface and writes the results of each.\n\n");
+  for (const InputOption &option : batchOptions) {
+    printf("   -%c,  --%s", option.shortOption, option.longOption);
+    if (option.argumentHelper)
+      printf(" %s", option.argumentHelper);
+    printf("\n");
+    printf("\t\t\t%s\n", option.helpString);
+  }
+  printf("\n");
+}
+
+void parseBatchArguments(int argc, char *argv[], BatchArguments &arguments) {
+  InputParser input(argc, argv);
+  if (hasBatchOption(input, 7) || argc == 2) {
+    batchHelpPage();
+    exit(0);
+  }
+
+  // Mode
+  std::string mode = getBatchOption(input, 0);
+  if (mode == "cycle")
+    arguments.inputType = CYCLE;
+  else if (mode == "border")
+    arguments.inputType = BORDER;
+  else {
+    printf("The `--%s` option expects `cycle` or `border`. Abort.\n",
+           batchOptions[0].longOption);
+    exit(0);
+  }
+
+  // Length, or the parity vector whose rotations are simulated
+  if (hasBatchOption(input, 6)) {
+    if (hasBatchOption(input, 1)) {
+      printf("The `--%s` option cannot be combined with `--%s`. Abort.\n",
+             batchOptions[6].longOption, batchOptions[1].longOption);
+      exit(0);
+    }
+    arguments.rotationsOf = getBatchOption(input, 6);
+    if (arguments.rotationsOf.find_first_not_of("01") != std::string::npos) {
+      printf("The `--%s` option expects a parity vector. Abort.\n",
+             batchOptions[6].longOption);
+      exit(0);
+    }
+    arguments.length = arguments.rotationsOf.size();
+  } else
+    arguments.length = atoi(getBatchOption(input, 1).c_str());
+  if (arguments.length < 1 || arguments.length > MAX_BATCH_LENGTH) {
+    printf("The `--%s` option expects a length between 1 and %d. Abort.\n",
+           batchOptions[1].longOption, MAX_BATCH_LENGTH);
+    exit(0);
+  }
+
+  // Threads
+  if (hasBatchOption(input, 2)) {
+    arguments.nbThreads = atoi(getBatchOption(input, 2).c_str());
+    if (arguments.nbThreads < 1) {
+      printf("The `--%s` option expects a positive number of threads. "
+             "Abort.\n",
+             batchOptions[2].longOption);
+      exit(0);
+    }
+  }
+  arguments.nbThreads = MAX(arguments.nbThreads, 1);
+
+  // Steps
+  if (hasBatchOption(input, 3)) {
+    arguments.maxSteps = atoi(getBatchOption(input, 3).c_str());
+    if (arguments.maxSteps < 1) {
+      printf("The `--%s` option expects a positive number of steps. "
+             "Abort.\n",
+             batchOptions[3].longOption);
+      exit(0);
+    }
+  }
+
+  // Output
+  if (hasBatchOption(input, 4)) {
+    arguments.outputPath = getBatchOption(input, 4);
+    if (arguments.outputPath.empty()) {
+      printf("The `--%s` option expects a file name. Abort.\n",
+             batchOptions[4].longOption);
+      exit(0);
+    }
+  }
+  arguments.isBinary = hasBatchOption(input, 5);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "arguments.h"
+#include "rotation_sweep.h"
+
+// A vector whose cycle is not detected, or whose border computation is not
+// done, after this many steps is reported as not resolved
+#define DEFAULT_BATCH_MAX_STEPS 4096
+// Parity vectors are indexed by 64 bits integers
+#define MAX_BATCH_LENGTH 62
+// Results a worker buffers before writing them
+#define BATCH_RESULTS_PER_FLUSH 256
+
+static std::vector<InputOption> batchOptions = {
+    {"mode", 'y', "cycle|border",
+     "Mode in which every parity vector of the given length is simulated. "
+     "Cycles are constructed per row."},
+    {"length", 'n', "LENGTH", "Length of the parity vectors, at most 62"},
+    {"threads", 'p', "NB THREADS",
+     "Number of worker threads, each simulates one parity vector at a time. "
+     "Defaults to the number of cores."},
+    {"max-steps", 'k', "NB STEPS",
+     "Simulation steps after which a parity vector is reported as not "
+     "resolved. Defaults to 4096."},
+    {"output", 'o', "FILE",
+     "Results are written to FILE instead of the standard output"},
+    {"binary", 'b', NULL,
+     "Results are written in binary instead of CSV, see `batch.cpp`"},
+    {"rotations", 'r', "INPUT PARITY VECTOR",
+     "Simulates the rotations of this parity vector instead of every parity "
+     "vector of a length"},
+    {"help", 'h', NULL, "Give this help list"}};
+
+struct BatchArguments {
+  InputType inputType; // BORDER or CYCLE
+  int length;
+  int nbThreads;
+  int maxSteps;
+  std::string outputPath; // Empty for the standard output
+  bool isBinary;
+  std::string rotationsOf; // Empty to simulate every parity vector
+
+  BatchArguments()
+      : inputType(NONE), length(0),
+        nbThreads(std::thread::hardware_concurrency()),
+        maxSteps(DEFAULT_BATCH_MAX_STEPS), isBinary(false) {}
+};
+
+// `simcqca batch [OPTION...]`, argv[1] is `batch`
+void parseBatchArguments(int argc, char *argv[], BatchArguments &arguments);
+void runBatch(const BatchArguments &arguments);
+
+class WorkStealingRanges {
+  /***
+   * Tasks 0 to nbTasks - 1 are split in one contiguous range per worker. A
+   * worker takes tasks from the front of its own range and, once it is
+   * empty, steals the back half of the largest remaining range. Tasks are
+   * never added so a worker which finds every range empty is done.
+   */
+public:
+  WorkStealingRanges(uint64_t nbTasks, int nbWorkers);
+
+  bool pop(int iWorker, uint64_t &iTask); // False once every task is taken
+
+private:
+  bool steal(int iWorker, uint64_t &iTask);
+
+  struct Range {
+    std::mutex mutex;
+    uint64_t begin, end;
+  };
+  std::vector<std::unique_ptr<Range>> ranges; // One per worker
+};
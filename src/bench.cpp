@@ -0,0 +1,358 @@
+/**
+ * simcqca_bench: runs each mode on random inputs of geometrically growing
+ * sizes and reports the performance of `World::next` as JSON, to compare
+ * commits with each other. Inputs only depend on the mode and the size.
+ *
+ * Each run is `BENCH_STEPS_PER_DIGIT` steps per input digit, the steps the
+ * base conversion of row and col modes needs. Border and cycle runs stop
+ * before if the computation is done or the cycle is detected: borders are
+ * done within 2 steps per digit but cycles may take exponentially many.
+ *
+ * The output is one object: the settings of the benchmark then `runs`, one
+ * object per mode and size with `steps`, `seconds`, `stepsPerSecond`,
+ * `cellsPerSecond`, `cells`, `peakCells` and `peakRssKiB`. When
+ * `isPeakRssPerRun` is false the peak RSS could not be reset between runs
+ * and is the peak of the process so far. With the fast engines, cells are
+ * written once the steps are timed and a step computes a whole row or
+ * column: there are more cells than after as many steps of the CA.
+ */
+
+#include "arguments.h"
+#include "world.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#define DEFAULT_BENCH_MIN_SIZE 16
+#define DEFAULT_BENCH_MAX_SIZE 4096
+#define DEFAULT_BENCH_GROWTH 2
+// Once a run of a mode takes longer, larger sizes of that mode are skipped
+#define DEFAULT_BENCH_MAX_SECONDS 10
+#define BENCH_STEPS_PER_DIGIT 4
+// Fixed so that inputs are the same from one commit to the other
+#define BENCH_SEED 0x5eed
+
+struct BenchMode {
+  const char *name; // As the option of the mode
+  InputType inputType;
+  bool constructCycleInLine;
+  bool cycleBoth;
+};
+
+static const std::vector<BenchMode> benchModes = {
+    {"row", LINE, false, false},
+    {"col", COL, false, false},
+    {"border", BORDER, false, false},
+    {"cycle", CYCLE, false, false},
+    {"cycle-row", CYCLE, true, false},
+    {"cycle-both", CYCLE, false, true}};
+
+static std::vector<InputOption> benchOptions = {
+    {"modes", 'y', "MODE[,MODE...]",
+     "Modes to run among row, col, border, cycle, cycle-row and cycle-both. "
+     "Defaults to all of them."},
+    {"min-size", 'm', "SIZE", "Size of the first input, defaults to 16"},
+    {"max-size", 'n', "SIZE", "Size of the last input, defaults to 4096"},
+    {"growth", 'g', "FACTOR",
+     "Each input is FACTOR times larger than the previous one, defaults to "
+     "2"},
+    {"max-seconds", 't', "SECONDS",
+     "Larger inputs of a mode are skipped once one run takes longer, "
+     "defaults to 10"},
+    {"threads", 'p', "NB THREADS",
+     "Number of threads used to find the updates of a step, defaults to 1"},
+    {"seq", 's', NULL, "Runs sequential simulations"},
+    {"fast", 'f', NULL, "Row and col modes use the fast engines"},
+    {"output", 'o', "FILE",
+     "The JSON is written to FILE instead of the standard output"},
+    {"help", 'h', NULL, "Give this help list"}};
+
+struct BenchArguments {
+  std::vector<BenchMode> modes;
+  int minSize, maxSize, growth;
+  double maxSeconds;
+  int nbThreads;
+  bool isSequential;
+  bool isFastEngineEnabled;
+  std::string outputPath; // Empty for the standard output
+
+  BenchArguments()
+      : minSize(DEFAULT_BENCH_MIN_SIZE), maxSize(DEFAULT_BENCH_MAX_SIZE),
+        growth(DEFAULT_BENCH_GROWTH), maxSeconds(DEFAULT_BENCH_MAX_SECONDS),
+        nbThreads(1), isSequential(false), isFastEngineEnabled(false) {}
+};
+
+struct BenchRun {
+  int nbSteps;
+  bool isResolved; // Border and cycle modes, always true in the others
+  double seconds;
+  size_t nbCells;
+  size_t peakNbCells;
+  long peakRssKiB; // -1 if unknown
+};
+
+static std::string randomInput(InputType inputType, int size) {
+  /**
+   * The first digit is not 0: row and col inputs have no leading zeros and
+   * border parity vectors are not all zeros, which never completes.
+   */
+  std::mt19937 generator(BENCH_SEED + 31 * size + inputType);
+  int base = inputType == COL ? 3 : 2;
+  std::string input(1, '1' + generator() % (base - 1));
+  while (static_cast<int>(input.size()) < size)
+    input.push_back('0' + generator() % base);
+  return input;
+}
+
+static bool resetPeakRss() {
+  /**
+   * Linux resets the VmHWM of /proc/self/status when 5 is written to
+   * /proc/self/clear_refs.
+   */
+  FILE *f = fopen("/proc/self/clear_refs", "w");
+  if (f == NULL)
+    return false;
+  bool isReset = fprintf(f, "5") == 1;
+  return fclose(f) == 0 && isReset;
+}
+
+static long readPeakRssKiB() {
+  FILE *f = fopen("/proc/self/status", "r");
+  if (f != NULL) {
+    char line[256];
+    long peakRssKiB = -1;
+    while (fgets(line, sizeof(line), f) != NULL)
+      if (strncmp(line, "VmHWM:", 6) == 0)
+        peakRssKiB = atol(line + 6);
+    fclose(f);
+    if (peakRssKiB >= 0)
+      return peakRssKiB;
+  }
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // Bytes
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+  return -1;
+}
+
+static BenchRun runOnce(const BenchArguments &arguments, const BenchMode &mode,
+                        int size) {
+  bool isRowOrCol = mode.inputType == LINE || mode.inputType == COL;
+  World world(arguments.isSequential, mode.inputType,
+              randomInput(mode.inputType, size), mode.constructCycleInLine,
+              mode.cycleBoth, arguments.isFastEngineEnabled && isRowOrCol);
+  world.setNbThreads(arguments.nbThreads);
+  world.setGraphicBufferEnabled(false);
+  int maxSteps = BENCH_STEPS_PER_DIGIT * size;
+  auto isResolved = [&]() {
+    if (mode.inputType == BORDER)
+      return world.isComputationDone();
+    if (mode.inputType == CYCLE)
+      return world.isCycleDetected();
+    return false;
+  };
+
+  BenchRun run;
+  run.peakNbCells = world.cells.size();
+  auto start = std::chrono::steady_clock::now();
+  run.isResolved = isResolved();
+  while (!run.isResolved && world.getNbSteps() < maxSteps) {
+    world.next();
+    run.peakNbCells = MAX(run.peakNbCells, world.cells.size());
+    run.isResolved = isResolved();
+  }
+  run.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+  run.nbSteps = world.getNbSteps();
+  // The fast engines only write their cells when asked, not in the timed
+  // steps. Row and col cells are never removed: the last count is the peak
+  world.materialize();
+  run.nbCells = world.cells.size();
+  run.peakNbCells = MAX(run.peakNbCells, run.nbCells);
+  run.isResolved |= isRowOrCol;
+  run.peakRssKiB = readPeakRssKiB();
+  return run;
+}
+
+static void writeRun(FILE *file, const BenchMode &mode, int size,
+                     const BenchRun &run, bool isFirst) {
+  double seconds = run.seconds > 0 ? run.seconds : 1e-9;
+  fprintf(file,
+          "%s\n    {\"mode\": \"%s\", \"size\": %d, \"steps\": %d, "
+          "\"isResolved\": %s, \"seconds\": %.6f, \"stepsPerSecond\": %.1f, "
+          "\"cellsPerSecond\": %.1f, \"cells\": %zu, \"peakCells\": %zu, "
+          "\"peakRssKiB\": %ld}",
+          isFirst ? "" : ",", mode.name, size, run.nbSteps,
+          run.isResolved ? "true" : "false", run.seconds,
+          run.nbSteps / seconds, run.nbCells / seconds, run.nbCells,
+          run.peakNbCells, run.peakRssKiB);
+  fflush(file);
+}
+
+static void runBench(const BenchArguments &arguments) {
+  FILE *file = stdout;
+  if (!arguments.outputPath.empty()) {
+    file = fopen(arguments.outputPath.c_str(), "w");
+    if (file == NULL) {
+      printf("Could not open `%s` to write the results. Abort.\n",
+             arguments.outputPath.c_str());
+      exit(0);
+    }
+  }
+  // Progress on the standard error when the JSON is on the standard output
+  FILE *progressFile = file == stdout ? stderr : stdout;
+
+  bool isPeakRssPerRun = resetPeakRss();
+  fprintf(file,
+          "{\n  \"version\": \"%d.%d\", \"threads\": %d, \"isSequential\": "
+          "%s, \"isFastEngineEnabled\": %s, \"isPeakRssPerRun\": %s,\n"
+          "  \"runs\": [",
+          simcqca_VERSION_MAJOR, simcqca_VERSION_MINOR, arguments.nbThreads,
+          arguments.isSequential ? "true" : "false",
+          arguments.isFastEngineEnabled ? "true" : "false",
+          isPeakRssPerRun ? "true" : "false");
+  bool isFirst = true;
+  for (const BenchMode &mode : arguments.modes)
+    for (long size = arguments.minSize; size <= arguments.maxSize;
+         size *= arguments.growth) {
+      if (isPeakRssPerRun)
+        resetPeakRss();
+      BenchRun run = runOnce(arguments, mode, size);
+      writeRun(file, mode, size, run, isFirst);
+      isFirst = false;
+      fprintf(progressFile, "%s %ld: %d steps in %.3fs\n", mode.name, size,
+              run.nbSteps, run.seconds);
+      if (run.seconds > arguments.maxSeconds)
+        break;
+    }
+  fprintf(file, "\n  ]\n}\n");
+
+  if (file != stdout && fclose(file) != 0) {
+    printf("Could not write the results to `%s`. Abort.\n",
+           arguments.outputPath.c_str());
+    exit(0);
+  }
+}
+
+static bool hasBenchOption(const InputParser &input, int iOption) {
+  std::string shortStr = "-";
+  shortStr.push_back(benchOptions[iOption].shortOption);
+  return input.cmdOptionExists(shortStr) ||
+         input.cmdOptionExists(std::string("--") +
+                               benchOptions[iOption].longOption);
+}
+
+static std::string getBenchOption(const InputParser &input, int iOption) {
+  std::string shortStr = "-";
+  shortStr.push_back(benchOptions[iOption].shortOption);
+  const std::string &shortValue = input.getCmdOption(shortStr);
+  if (!shortValue.empty())
+    return shortValue;
+  return input.getCmdOption(std::string("--") +
+                            benchOptions[iOption].longOption);
+}
+
+static void benchHelpPage() {
+  printf("Usage ./simcqca_bench [OPTION...]\n");
+  printf("Runs each mode on random inputs of growing sizes and writes the "
+         "performance of each run as JSON.\n\n");
+  for (const InputOption &option : benchOptions) {
+    printf("   -%c,  --%s", option.shortOption, option.longOption);
+    if (option.argumentHelper)
+      printf(" %s", option.argumentHelper);
+    printf("\n");
+    printf("\t\t\t%s\n", option.helpString);
+  }
+  printf("\n");
+}
+
+static int getPositiveBenchOption(const InputParser &input, int iOption,
+                                  int minValue) {
+  int value = atoi(getBenchOption(input, iOption).c_str());
+  if (value < minValue) {
+    printf("The `--%s` option expects a number greater or equal to %d. "
+           "Abort.\n",
+           benchOptions[iOption].longOption, minValue);
+    exit(0);
+  }
+  return value;
+}
+
+static void parseBenchArguments(int argc, char *argv[],
+                                BenchArguments &arguments) {
+  InputParser input(argc, argv);
+  if (hasBenchOption(input, 9)) {
+    benchHelpPage();
+    exit(0);
+  }
+
+  // Modes
+  if (hasBenchOption(input, 0)) {
+    std::string modes = getBenchOption(input, 0) + ",";
+    for (size_t iEnd = modes.find(','); iEnd != std::string::npos;
+         iEnd = modes.find(',')) {
+      std::string name = modes.substr(0, iEnd);
+      modes.erase(0, iEnd + 1);
+      auto it = std::find_if(
+          benchModes.begin(), benchModes.end(),
+          [&](const BenchMode &mode) { return name == mode.name; });
+      if (it == benchModes.end()) {
+        printf("Unknown mode `%s` for the `--%s` option. Abort.\n",
+               name.c_str(), benchOptions[0].longOption);
+        exit(0);
+      }
+      arguments.modes.push_back(*it);
+    }
+  } else
+    arguments.modes = benchModes;
+
+  // Sizes
+  if (hasBenchOption(input, 1))
+    arguments.minSize = getPositiveBenchOption(input, 1, 1);
+  if (hasBenchOption(input, 2))
+    arguments.maxSize = getPositiveBenchOption(input, 2, arguments.minSize);
+  if (hasBenchOption(input, 3))
+    arguments.growth = getPositiveBenchOption(input, 3, 2);
+  if (hasBenchOption(input, 4))
+    arguments.maxSeconds = getPositiveBenchOption(input, 4, 1);
+
+  // Simulation
+  if (hasBenchOption(input, 5))
+    arguments.nbThreads = getPositiveBenchOption(input, 5, 1);
+  arguments.isSequential = hasBenchOption(input, 6);
+  arguments.isFastEngineEnabled = hasBenchOption(input, 7);
+  if (arguments.isSequential && arguments.isFastEngineEnabled) {
+    printf("The `--%s` option cannot be combined with sequential "
+           "simulation. Abort.\n",
+           benchOptions[7].longOption);
+    exit(0);
+  }
+
+  // Output
+  if (hasBenchOption(input, 8)) {
+    arguments.outputPath = getBenchOption(input, 8);
+    if (arguments.outputPath.empty()) {
+      printf("The `--%s` option expects a file name. Abort.\n",
+             benchOptions[8].longOption);
+      exit(0);
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  BenchArguments arguments;
+  parseBenchArguments(argc, argv, arguments);
+  runBench(arguments);
+  return 0;
+}
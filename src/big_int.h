@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Below these sizes (in limbs) the quadratic algorithms are faster
+#define KARATSUBA_THRESHOLD 32
+// Digits converted one by one at the leaves of `fromDigits`
+#define DIGITS_PER_LEAF 256
+// Larger numbers are not printed in decimal by `toReadout`
+#define MAX_DECIMAL_READOUT_BITS 4096
+
+class BigInt {
+  /***
+   * Non negative arbitrary precision integer, 32 bits limbs least
+   * significant first. Only what base conversions and the parity vector
+   * solver need: Karatsuba multiplication and divide and conquer conversion
+   * from any small base, which is O(M(n) log n) instead of quadratic.
+   */
+public:
+  BigInt() {}
+  explicit BigInt(uint32_t value);
+
+  // Digits are given most significant first
+  static BigInt fromDigits(const std::vector<uint32_t> &digits, uint32_t base);
+  static BigInt fromString(const std::string &digits, uint32_t base); // '0'..
+
+  static BigInt power(uint32_t base, size_t exponent);
+
+  std::string toBase2() const;   // "" for 0, as `World::base32`
+  std::string toDecimal() const; // Quadratic, for numbers to be read
+  std::string toReadout() const; // Decimal, or only the size if too large
+  size_t getNbBits() const;
+  bool isZero() const { return limbs.empty(); }
+  bool isOdd() const { return !limbs.empty() && (limbs[0] & 1); }
+
+  BigInt operator+(const BigInt &other) const;
+  BigInt operator-(const BigInt &other) const; // `other` must not be larger
+  BigInt operator*(const BigInt &other) const;
+  BigInt operator<<(size_t nbBits) const;
+  BigInt operator>>(size_t nbBits) const;
+  BigInt lowBits(size_t nbBits) const; // Modulo 2^nbBits
+  uint32_t divideBy(uint32_t divisor); // In place, returns the remainder
+  void divideExactlyBy(uint32_t divisor); // Odd, and no remainder
+  uint32_t modulo3() const;
+  bool operator==(const BigInt &other) const { return limbs == other.limbs; }
+  bool operator!=(const BigInt &other) const { return limbs != other.limbs; }
+  bool operator<(const BigInt &other) const;
+
+private:
+  static BigInt fromDigitsRange(const uint32_t *digits, size_t nbDigits,
+                                uint32_t base, std::vector<BigInt> &powers);
+  void trim();
+
+  std::vector<uint32_t> limbs; // No most significant 0 limb
+};
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "global.h"
+
+enum AtomicInfo : signed char {
+  /***
+   * Bits and carrys can be either 0, 1 or undef (\bot in latex).
+   */
+  UNDEF = -1,
+  ZERO = 0,
+  ONE = 1
+};
+
+enum CellStatus {
+  UNDEFINED = -1,   // bot bit and carry undefined
+  HALF_DEFINED = 1, // bit defined and carry undefined
+  DEFINED = 2       // bit-carry defined
+};
+
+struct Cell {
+  /***
+   * A cell contains a bit and a carry.
+   */
+  AtomicInfo bit, carry;
+  bool isBootstrappingCarry;
+  Cell(AtomicInfo bit = UNDEF, AtomicInfo carry = UNDEF,
+       bool isBootstrappingCarry = false)
+      : bit(bit), carry(carry), isBootstrappingCarry(isBootstrappingCarry) {}
+  CellStatus getStatus() const {
+    if (bit == UNDEF && carry == UNDEF)
+      return UNDEFINED;
+    if (bit != UNDEF && carry == UNDEF)
+      return HALF_DEFINED;
+    if (bit != UNDEF && carry != UNDEF)
+      return DEFINED;
+    assert(false); // We should never meet the case where only the carry is
+                   // defined
+  }
+  int sum() const {
+    assert(getStatus() == DEFINED);
+    return static_cast<int>(bit) + static_cast<int>(carry);
+  }
+  int index() const {
+    /**
+     * Indexing in order {(0,0),(0,1),(1,0),(1,1)}.
+     */
+    assert(getStatus() == DEFINED);
+    return static_cast<int>(2 * bit) + static_cast<int>(carry);
+  }
+};
+
+// Cells are stored in square tiles of side 2^TILE_SHIFT
+#define TILE_SHIFT 6
+#define TILE_SIDE (1 << TILE_SHIFT)
+#define TILE_MASK (TILE_SIDE - 1)
+
+// Packed cells are nibbles: a 3 bits state and the bootstrapping flag
+#define PACKED_ABSENT 0
+#define PACKED_UNDEFINED 1
+#define PACKED_HALF_DEFINED 2 // + bit
+#define PACKED_DEFINED 4      // + index
+#define PACKED_BOOTSTRAPPING_FLAG 8
+
+static inline uint8_t packCell(const Cell &cell) {
+  uint8_t packed = PACKED_UNDEFINED;
+  switch (cell.getStatus()) {
+  case HALF_DEFINED:
+    packed = PACKED_HALF_DEFINED + static_cast<int>(cell.bit);
+    break;
+  case DEFINED:
+    packed = PACKED_DEFINED + cell.index();
+    break;
+  default:
+    break;
+  }
+  if (cell.isBootstrappingCarry)
+    packed |= PACKED_BOOTSTRAPPING_FLAG;
+  return packed;
+}
+
+static inline Cell unpackCell(uint8_t packed) {
+  bool isBootstrappingCarry = packed & PACKED_BOOTSTRAPPING_FLAG;
+  packed &= ~PACKED_BOOTSTRAPPING_FLAG;
+  if (packed >= PACKED_DEFINED)
+    return Cell(static_cast<AtomicInfo>((packed - PACKED_DEFINED) / 2),
+                static_cast<AtomicInfo>((packed - PACKED_DEFINED) % 2),
+                isBootstrappingCarry);
+  if (packed >= PACKED_HALF_DEFINED)
+    return Cell(static_cast<AtomicInfo>(packed - PACKED_HALF_DEFINED), UNDEF,
+                isBootstrappingCarry);
+  return Cell(UNDEF, UNDEF, isBootstrappingCarry);
+}
+
+struct Tile {
+  /***
+   * A dense square of packed cells, two cells per byte. Cells are laid out
+   * row by row so that EAST/WEST neighbours are contiguous in memory.
+   */
+  uint8_t packed[TILE_SIDE * TILE_SIDE / 2];
+  Tile() { memset(packed, PACKED_ABSENT, sizeof(packed)); }
+
+  uint8_t get(int iCell) const {
+    uint8_t pair = packed[iCell >> 1];
+    return (iCell & 1) ? (pair >> 4) : (pair & 0xF);
+  }
+  void set(int iCell, uint8_t packedCell) {
+    uint8_t &pair = packed[iCell >> 1];
+    if (iCell & 1)
+      pair = (pair & 0x0F) | (packedCell << 4);
+    else
+      pair = (pair & 0xF0) | packedCell;
+  }
+};
+
+struct TileKeyHash {
+  size_t operator()(uint64_t key) const {
+    // splitmix64 finalizer, tile keys are far from uniformly distributed
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+  }
+};
+
+typedef std::unordered_set<uint64_t, TileKeyHash> TileKeySet;
+
+// Out-of-core tiles are paged in and out by chunks of tiles, a multiple of
+// the page size
+#define TILES_PER_CHUNK 32
+
+class TileArena {
+  /***
+   * Tiles kept in a memory mapped scratch file instead of the heap, so that
+   * the world can outgrow the physical memory. The mapping is reserved once
+   * and never moves: tile pointers stay valid while the file grows.
+   * Chunks written to are counted as resident. Past the resident budget the
+   * least recently written ones are paged out (clock algorithm), the kernel
+   * pages them back in transparently when they are read again.
+   */
+public:
+  TileArena(const std::string &path, size_t residentBudget); // In bytes
+  ~TileArena();
+
+  Tile *allocate();
+  void release(Tile *tile); // The tile is reused by a later `allocate`
+  void clear();
+  void touch(const Tile *tile) { // Called before writing to `tile`
+    size_t iChunk = (tile - base) / TILES_PER_CHUNK;
+    if (!isReferenced[iChunk])
+      markReferenced(iChunk);
+  }
+  size_t getNbTiles() const { return nbUsedTiles - freeTiles.size(); }
+  size_t getResidentBytes() const {
+    return nbResidentChunks * TILES_PER_CHUNK * sizeof(Tile);
+  }
+
+private:
+  void markReferenced(size_t iChunk);
+  void pageOut();
+
+  int fd;
+  Tile *base;              // Start of the mapping
+  size_t nbReservedTiles;  // Size of the mapping
+  size_t nbFileTiles;      // Size of the file
+  size_t nbUsedTiles;      // Tiles after are never allocated yet
+  std::vector<Tile *> freeTiles;
+  std::vector<uint8_t> isResident, isReferenced; // Per chunk
+  size_t nbResidentChunks, nbBudgetChunks;
+  size_t clockHand;
+};
+
+class CellStore {
+  /***
+   * Sparse storage for the cells of the world: a hash of dense tiles of
+   * packed cells (half a byte per cell).
+   * Cells are read by value, a cell exists once it has been `set`.
+   * Tiles are on the heap unless the store is mapped to a file.
+   */
+public:
+  CellStore() : nbCells(0) {}
+  ~CellStore() { clear(); }
+
+  // Out-of-core mode, existing tiles are moved to the file
+  void mapToFile(const std::string &path, size_t residentBudget);
+  const TileArena *getArena() const { return arena.get(); }
+
+  bool contains(const Vector2i &cellPos) const {
+    return getPacked(cellPos) != PACKED_ABSENT;
+  }
+
+  uint8_t getPacked(const Vector2i &cellPos) const {
+    const Tile *tile = findTile(cellPos);
+    if (tile == NULL)
+      return PACKED_ABSENT;
+    return tile->get(localIndex(cellPos));
+  }
+
+  Cell operator[](const Vector2i &cellPos) const {
+    return unpackCell(getPacked(cellPos));
+  }
+
+  void set(const Vector2i &cellPos, const Cell &cell) {
+    Tile &tile = getOrCreateTile(cellPos);
+    int iCell = localIndex(cellPos);
+    if (tile.get(iCell) == PACKED_ABSENT)
+      nbCells += 1;
+    tile.set(iCell, packCell(cell));
+  }
+
+  size_t size() const { return nbCells; }
+  size_t getNbTiles() const { return tiles.size(); }
+  void clear();
+
+  static uint64_t tileKey(const Vector2i &cellPos) {
+    uint32_t tileX = static_cast<uint32_t>(cellPos.x >> TILE_SHIFT);
+    uint32_t tileY = static_cast<uint32_t>(cellPos.y >> TILE_SHIFT);
+    return (static_cast<uint64_t>(tileX) << 32) | tileY;
+  }
+  static Vector2i tileOrigin(uint64_t key) { // North west cell of a tile
+    return Vector2i(static_cast<int32_t>(key >> 32) * TILE_SIDE,
+                    static_cast<int32_t>(key & 0xFFFFFFFF) * TILE_SIDE);
+  }
+
+  // Snapshots: tiles are saved and restored as raw packed bytes
+  template <typename Callback> void forEachTile(Callback onTile) const {
+    for (const auto &keyAndTile : tiles)
+      onTile(keyAndTile.first, *keyAndTile.second);
+  }
+  void restoreTile(uint64_t key, const uint8_t *packed, size_t nbTileCells);
+  static int countCells(const Tile &tile);
+
+  template <typename Callback>
+  size_t evictDefinedTiles(const TileKeySet &keptTiles,
+                           Callback onEvictedCell) {
+    /**
+     * Removes the tiles which are not in `keptTiles` and whose cells are all
+     * defined. `onEvictedCell` is called on each of their cells beforehand.
+     * Returns the number of evicted cells.
+     */
+    size_t nbEvicted = 0;
+    for (auto it = tiles.begin(); it != tiles.end();) {
+      if (keptTiles.count(it->first) || !isTileDefined(*it->second)) {
+        ++it;
+        continue;
+      }
+      Vector2i origin = tileOrigin(it->first);
+      for (int iCell = 0; iCell < TILE_SIDE * TILE_SIDE; iCell += 1) {
+        uint8_t packed = it->second->get(iCell);
+        if (packed == PACKED_ABSENT)
+          continue;
+        onEvictedCell(origin + Vector2i(iCell & TILE_MASK, iCell >> TILE_SHIFT),
+                      unpackCell(packed));
+        nbCells -= 1;
+        nbEvicted += 1;
+      }
+      deleteTile(it->second);
+      it = tiles.erase(it);
+    }
+    return nbEvicted;
+  }
+
+private:
+  static bool isTileDefined(const Tile &tile) {
+    for (int iCell = 0; iCell < TILE_SIDE * TILE_SIDE; iCell += 1) {
+      uint8_t packed = tile.get(iCell) & ~PACKED_BOOTSTRAPPING_FLAG;
+      if (packed != PACKED_ABSENT && packed < PACKED_DEFINED)
+        return false;
+    }
+    return true;
+  }
+  static int localIndex(const Vector2i &cellPos) {
+    return (cellPos.y & TILE_MASK) * TILE_SIDE + (cellPos.x & TILE_MASK);
+  }
+
+  const Tile *findTile(const Vector2i &cellPos) const {
+    auto it = tiles.find(tileKey(cellPos));
+    if (it == tiles.end())
+      return NULL;
+    return it->second;
+  }
+  Tile &getOrCreateTile(const Vector2i &cellPos);
+  Tile *newTile();
+  void deleteTile(Tile *tile);
+
+  std::unordered_map<uint64_t, Tile *, TileKeyHash> tiles; // Owned
+  std::unique_ptr<TileArena> arena; // NULL when tiles are on the heap
+  size_t nbCells;
+};
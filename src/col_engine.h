@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "big_int.h"
+#include "cell_store.h"
+#include "global.h"
+#include "row_engine.h"
+
+struct PackedCol {
+  /***
+   * Part of a COL mode column north of row 0, stored as packed trits: 5
+   * trits per byte, most significant trit first. Bytes before `firstByte`
+   * are all 0 and are not stored.
+   */
+  std::vector<uint8_t> bytes;
+  int firstByte;
+};
+
+class ColEngine {
+  /***
+   * Fast engine for COL mode. North of row 0, column x = -j holds N / 2^j
+   * (rounded down) in base 3 where N is the input. A column is the half of
+   * the column east of it, it is computed 5 trits at a time with a lookup
+   * table instead of cell by cell.
+   * South of row 0 the world is the LINE mode world of N written in binary,
+   * it is computed by a row engine.
+   * The cells are only produced on demand by `materializeCol` and are
+   * identical to the ones the CA rule computes.
+   */
+public:
+  ColEngine() : height(0), padding(0), nbCols(0) {}
+  explicit ColEngine(const std::vector<int> &base3p);
+
+  void next();               // Computes one more column and one more row
+  void advance(int nbSteps); // Computes `nbSteps` more columns and rows
+  int getNbCols() const { return nbCols; }
+  int getColTop(int iCol) const; // Northernmost cell of column x = -iCol,
+                                 // 0 if none north of row 0
+  void materializeCol(int iCol,
+                      std::vector<std::pair<Vector2i, Cell>> &out) const;
+  void forgetColsBefore(int iCol); // Frees columns which are not needed
+                                   // anymore
+
+  RowEngine rowEngine; // South of row 0
+
+private:
+  const PackedCol &getCol(int iCol) const;
+  int getTrit(const PackedCol &col, int y) const;
+  std::string toBinary(const PackedCol &col) const;
+
+  std::vector<int> inputCol;  // Base 3' digits of the input column
+  std::deque<PackedCol> cols; // Computed columns not forgotten yet
+  int height;                 // Number of input trits
+  int padding;                // Leading 0 trits to fill the first byte
+  int nbCols;
+};
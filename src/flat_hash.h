@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "vector2i.h"
+
+static inline uint64_t packPos(const Vector2i &pos) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(pos.x)) << 32) |
+         static_cast<uint32_t>(pos.y);
+}
+
+static inline size_t hashPos(const Vector2i &pos) {
+  // splitmix64 finalizer, neighbouring positions must not collide
+  uint64_t key = packPos(pos);
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return static_cast<size_t>(key);
+}
+
+static inline const Vector2i &getEntryPos(const Vector2i &entry) {
+  return entry;
+}
+
+template <typename Value>
+static inline const Vector2i &
+getEntryPos(const std::pair<Vector2i, Value> &entry) {
+  return entry.first;
+}
+
+template <typename Entry> class FlatPosTable {
+  /***
+   * Open addressing hash table (linear probing) keyed on world positions.
+   * Entries are stored inline in a single array: inserting does not allocate
+   * once the capacity is reached and `clear` keeps the capacity.
+   * Iteration order is unspecified.
+   */
+public:
+  class iterator {
+  public:
+    iterator(const FlatPosTable *table, size_t iSlot)
+        : table(table), iSlot(iSlot) {
+      skipFreeSlots();
+    }
+    Entry &operator*() const {
+      return const_cast<Entry &>(table->entries[iSlot]);
+    }
+    Entry *operator->() const { return &**this; }
+    iterator &operator++() {
+      iSlot += 1;
+      skipFreeSlots();
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return iSlot == other.iSlot;
+    }
+    bool operator!=(const iterator &other) const {
+      return iSlot != other.iSlot;
+    }
+
+  private:
+    void skipFreeSlots() {
+      while (iSlot < table->isUsed.size() && !table->isUsed[iSlot])
+        iSlot += 1;
+    }
+    const FlatPosTable *table;
+    size_t iSlot;
+  };
+  typedef iterator const_iterator;
+
+  FlatPosTable() : nbEntries(0) {}
+
+  size_t size() const { return nbEntries; }
+  bool empty() const { return nbEntries == 0; }
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, isUsed.size()); }
+
+  // Slots can be split in ranges to iterate over parts of the table in
+  // parallel, ranges are visited in the same order as by `begin`/`end`
+  size_t getNbSlots() const { return isUsed.size(); }
+  iterator iteratorAt(size_t iSlot) const { return iterator(this, iSlot); }
+
+  void reserve(size_t nbEntriesToHold) {
+    size_t capacity = 16;
+    while (capacity < 2 * nbEntriesToHold)
+      capacity *= 2;
+    if (capacity > isUsed.size())
+      rehash(capacity);
+  }
+
+  void clear() {
+    /**
+     * Empties the table without freeing its memory.
+     */
+    if (nbEntries == 0)
+      return;
+    std::fill(isUsed.begin(), isUsed.end(), 0);
+    nbEntries = 0;
+  }
+
+  iterator find(const Vector2i &pos) const {
+    if (nbEntries == 0)
+      return end();
+    size_t iSlot = findSlot(pos);
+    return isUsed[iSlot] ? iterator(this, iSlot) : end();
+  }
+
+  size_t count(const Vector2i &pos) const {
+    return find(pos) != end() ? 1 : 0;
+  }
+
+  std::pair<iterator, bool> insert(const Entry &entry) {
+    if (2 * (nbEntries + 1) > isUsed.size())
+      rehash(isUsed.empty() ? 16 : 2 * isUsed.size());
+    size_t iSlot = findSlot(getEntryPos(entry));
+    if (isUsed[iSlot])
+      return std::make_pair(iterator(this, iSlot), false);
+    entries[iSlot] = entry;
+    isUsed[iSlot] = 1;
+    nbEntries += 1;
+    return std::make_pair(iterator(this, iSlot), true);
+  }
+
+  size_t erase(const Vector2i &pos) {
+    /**
+     * Backward shift deletion: no tombstones, later probes stay short.
+     */
+    if (nbEntries == 0)
+      return 0;
+    size_t mask = isUsed.size() - 1;
+    size_t iHole = findSlot(pos);
+    if (!isUsed[iHole])
+      return 0;
+    isUsed[iHole] = 0;
+    nbEntries -= 1;
+    for (size_t iSlot = (iHole + 1) & mask; isUsed[iSlot];
+         iSlot = (iSlot + 1) & mask) {
+      size_t iHome = hashPos(getEntryPos(entries[iSlot])) & mask;
+      // The entry can fill the hole if its home is not in (hole, slot]
+      if (((iSlot - iHome) & mask) >= ((iSlot - iHole) & mask)) {
+        entries[iHole] = entries[iSlot];
+        isUsed[iHole] = 1;
+        isUsed[iSlot] = 0;
+        iHole = iSlot;
+      }
+    }
+    return 1;
+  }
+
+protected:
+  size_t findSlot(const Vector2i &pos) const {
+    /**
+     * Slot holding `pos`, or the free slot where it would be inserted.
+     */
+    size_t mask = isUsed.size() - 1;
+    size_t iSlot = hashPos(pos) & mask;
+    while (isUsed[iSlot] && getEntryPos(entries[iSlot]) != pos)
+      iSlot = (iSlot + 1) & mask;
+    return iSlot;
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<Entry> oldEntries;
+    std::vector<uint8_t> oldIsUsed;
+    oldEntries.swap(entries);
+    oldIsUsed.swap(isUsed);
+    entries.assign(capacity, Entry());
+    isUsed.assign(capacity, 0);
+    for (size_t iSlot = 0; iSlot < oldIsUsed.size(); iSlot += 1)
+      if (oldIsUsed[iSlot]) {
+        size_t iNewSlot = findSlot(getEntryPos(oldEntries[iSlot]));
+        entries[iNewSlot] = oldEntries[iSlot];
+        isUsed[iNewSlot] = 1;
+      }
+  }
+
+  std::vector<Entry> entries;
+  std::vector<uint8_t> isUsed; // Capacity is always a power of 2
+  size_t nbEntries;
+};
+
+typedef FlatPosTable<Vector2i> FlatPosSet;
+
+template <typename Value>
+class FlatPosMap : public FlatPosTable<std::pair<Vector2i, Value>> {
+public:
+  Value &operator[](const Vector2i &pos) {
+    return this->insert(std::make_pair(pos, Value())).first->second;
+  }
+};
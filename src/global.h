@@ -1,7 +1,6 @@
 #pragma once
 
 #include <assert.h>
-#include <set>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -15,29 +14,16 @@
 #define MIN(X, Y) ((X < Y) ? X : Y)
 #define MAX(X, Y) ((X < Y) ? Y : X)
 
-#include <SFML/Graphics.hpp> // for sf::Vector2i
+#include "vector2i.h"
 
-#define EAST sf::Vector2i({1, 0})
-#define WEST sf::Vector2i({-1, 0})
-#define SOUTH sf::Vector2i({0, 1})
-#define NORTH sf::Vector2i({0, -1})
+#define EAST Vector2i({1, 0})
+#define WEST Vector2i({-1, 0})
+#define SOUTH Vector2i({0, 1})
+#define NORTH Vector2i({0, -1})
 
-struct compareWorldPositions {
-  bool operator()(const sf::Vector2<int> &a, const sf::Vector2<int> &b) const {
-    if (a.x == b.x)
-      return a.y < b.y;
-    return a.x < b.x;
-  }
-};
-
-static sf::Vector2i operator*(int scalar, const sf::Vector2i &vector) {
-  sf::Vector2i toReturn = vector;
-  for (int i = 0; i < scalar; i += 1)
-    toReturn += vector;
-  return toReturn;
-}
+#include "flat_hash.h"
 
-typedef std::set<sf::Vector2i, compareWorldPositions> Poset;
+typedef FlatPosSet Poset;
 
 static void saveFile(const std::string &filePath,
                      const std::string &fileContent) {
@@ -1,8 +1,9 @@
 #include "graphic_engine.h"
 
 GraphicEngine::GraphicEngine(World &world, int screen_w, int screen_h,
-                             bool isTikzEnabled)
-    : world(world), isTikzEnabled(isTikzEnabled) {
+                             bool isTikzEnabled,
+                             const std::string &snapshotPath)
+    : world(&world), isTikzEnabled(isTikzEnabled), snapshotPath(snapshotPath) {
   window.create(sf::VideoMode(screen_w, screen_h), simcqca_PROG_NAME);
   window.setFramerateLimit(TARGET_FPS);
 
@@ -29,13 +30,20 @@ GraphicEngine::GraphicEngine(World &world, int screen_w, int screen_h,
 
   initGraphicBuffers();
 
+  // Streaming mode, the quads of evicted cells are removed at next update
+  if (world.isStreaming())
+    world.addEvictionCallback(
+        [this](const Vector2i &cellPos, const Cell &) {
+          evictedCellBuffer.push_back(cellPos);
+        });
+
   tikzMode = isTikzEnabled;
   isTikzGridEnabled = false;
 }
 
 GraphicEngine::~GraphicEngine() {}
 
-sf::Vector2f GraphicEngine::mapWorldPosToCoords(const sf::Vector2i &cellPos) {
+sf::Vector2f GraphicEngine::mapWorldPosToCoords(const Vector2i &cellPos) {
   /**
    * Transform cell position to graphic coordinates.
    */
@@ -43,13 +51,13 @@ sf::Vector2f GraphicEngine::mapWorldPosToCoords(const sf::Vector2i &cellPos) {
                        static_cast<float>(cellPos.y * CELL_H)});
 }
 
-sf::Vector2i GraphicEngine::mapCoordsToWorldPos(const sf::Vector2f &coords) {
+Vector2i GraphicEngine::mapCoordsToWorldPos(const sf::Vector2f &coords) {
   /**
    * Transforms graphic coordinates to cell position.
    */
   int signX = (coords.x < 0) ? -1 * CELL_W : 0;
   int signY = (coords.y < 0) ? -1 * CELL_H : 0;
-  return sf::Vector2i({static_cast<int>((coords.x + signX) / CELL_W),
+  return Vector2i({static_cast<int>((coords.x + signX) / CELL_W),
                        static_cast<int>((coords.y + signY) / CELL_H)});
 }
 
@@ -75,6 +83,7 @@ void GraphicEngine::reset() {
     graphicCells[iLayer].clear();
     vertexArrayCell[iLayer].clear();
   }
+  evictedCellBuffer.clear();
   initGraphicBuffers();
 
   if (isTikzEnabled) {
@@ -84,35 +93,55 @@ void GraphicEngine::reset() {
   }
 }
 
+void GraphicEngine::rotate(int direction) {
+  /**
+   * Rotates the parity vector. Worlds of the rotations are computed
+   * concurrently and cached: going back to a rotation is instant. In
+   * streaming mode, evicted cells would be lost, the world is rotated in
+   * place instead.
+   */
+  reset();
+  if (world->isStreaming())
+    world->rotate(direction);
+  else {
+    if (!rotations)
+      rotations.reset(new RotationSweep(*world, world->getNbThreads()));
+    world = &rotations->rotate(direction);
+    world->redraw();
+  }
+  while (isSimulationInView())
+    world->next();
+}
+
 bool GraphicEngine::isSimulationInView() {
   /**
    * Checks whether the simulation is strictly contained in the view or not.
    */
   auto boundaries = getExtremalVisibleCellsPos();
   bool inView = false;
-  if (world.inputType == LINE || world.inputType == COL)
-    for (const auto &cellPos : world.cellsOnEdge)
+  if (world->inputType == LINE || world->inputType == COL)
+    for (const auto &cellPos : world->cellsOnEdge)
       if (cellPos.x >= boundaries.first.x)
         inView = true;
-  if (world.inputType == BORDER || world.inputType == CYCLE) {
-    if (world.inputType == BORDER && world.isComputationDone())
+  if (world->inputType == BORDER || world->inputType == CYCLE) {
+    if (world->inputType == BORDER && world->isComputationDone())
       return false;
 
-    if (world.cycleBoth) {
-      for (const auto &cellPos : world.cellsOnEdge)
+    if (world->cycleBoth) {
+      for (const auto &cellPos : world->cellsOnEdge)
         if (cellPos.y >= boundaries.first.y &&
             cellPos.x >= boundaries.first.x) {
           inView = true;
         }
     } else {
-      if (!world.constructCycleInLine) {
-        for (const auto &cellPos : world.cellsOnEdge)
+      if (!world->constructCycleInLine) {
+        for (const auto &cellPos : world->cellsOnEdge)
           if (cellPos.y >= boundaries.first.y) {
             inView = true;
           }
       }
-      if (world.constructCycleInLine) {
-        for (const auto &cellPos : world.cellsOnEdge)
+      if (world->constructCycleInLine) {
+        for (const auto &cellPos : world->cellsOnEdge)
           if (cellPos.x >= boundaries.first.x)
             inView = true;
       }
@@ -122,7 +151,7 @@ bool GraphicEngine::isSimulationInView() {
   return inView;
 }
 
-void GraphicEngine::toggleSelectedCell(const sf::Vector2i &cellPos,
+void GraphicEngine::toggleSelectedCell(const Vector2i &cellPos,
                                        bool onlyAdd, bool toggleParityVector) {
   /**
    * Select the cell if not selected and unselect otherwise. If `onlyAdd` is on
@@ -131,23 +160,24 @@ void GraphicEngine::toggleSelectedCell(const sf::Vector2i &cellPos,
   if (selectedCells.find(cellPos) == selectedCells.end()) {
     selectedCells[cellPos] = currentSelectedColor;
     if (toggleParityVector) {
-      assert(world.inputType == CYCLE);
+      assert(world->inputType == CYCLE);
       selectedBorder[cellPos] = currentSelectedColor;
-      selectedCells[cellPos - world.cyclicForwardVector] = currentSelectedColor;
+      selectedCells[cellPos - world->cyclicForwardVector] =
+          currentSelectedColor;
     }
   } else if (!onlyAdd) {
     selectedCells.erase(cellPos);
-    if (world.inputType == CYCLE) {
+    if (world->inputType == CYCLE) {
       if (selectedBorder.find(cellPos) != selectedBorder.end())
         selectedBorder.erase(cellPos);
-      if (selectedCells.find(cellPos - world.cyclicForwardVector) !=
+      if (selectedCells.find(cellPos - world->cyclicForwardVector) !=
           selectedCells.end())
-        selectedCells.erase(cellPos - world.cyclicForwardVector);
+        selectedCells.erase(cellPos - world->cyclicForwardVector);
     }
   }
 }
 
-void GraphicEngine::clearSelectedColor(const sf::Vector2i &cellPos) {
+void GraphicEngine::clearSelectedColor(const Vector2i &cellPos) {
   /**
    * If cell is selected, clears all cells with that color.
    */
@@ -156,7 +186,7 @@ void GraphicEngine::clearSelectedColor(const sf::Vector2i &cellPos) {
     return;
 
   int colorId = selectedCells[cellPos];
-  std::vector<sf::Vector2i> toErase;
+  std::vector<Vector2i> toErase;
   for (const auto &posAndColor : selectedCells)
     if (posAndColor.second == colorId)
       toErase.push_back(posAndColor.first);
@@ -166,11 +196,11 @@ void GraphicEngine::clearSelectedColor(const sf::Vector2i &cellPos) {
 
 void GraphicEngine::handleSelectorsEvents(const sf::Event &event) {
   if (event.type == sf::Event::MouseButtonPressed) {
-    sf::Vector2i clickedCellPos = mapCoordsToWorldPos(
+    Vector2i clickedCellPos = mapCoordsToWorldPos(
         window.mapPixelToCoords(sf::Mouse::getPosition(window)));
     if ((event.mouseButton.button == sf::Mouse::Left)) {
       bool toggleParityVec = false;
-      if (world.inputType == CYCLE && isAltPressed())
+      if (world->inputType == CYCLE && isAltPressed())
         toggleParityVec = true;
       toggleSelectedCell(clickedCellPos, false, toggleParityVec);
     }
@@ -181,7 +211,7 @@ void GraphicEngine::handleSelectorsEvents(const sf::Event &event) {
 
   if (event.type == sf::Event::MouseMoved) {
     if (sf::Mouse::isButtonPressed(sf::Mouse::Left) && isControlPressed()) {
-      sf::Vector2i hoveredCellPos = mapCoordsToWorldPos(
+      Vector2i hoveredCellPos = mapCoordsToWorldPos(
           window.mapPixelToCoords(sf::Mouse::getPosition(window)));
       toggleSelectedCell(hoveredCellPos, true);
     }
@@ -207,75 +237,39 @@ void GraphicEngine::handleSelectorsEvents(const sf::Event &event) {
   }
 }
 
-void GraphicEngine::outlineResult() {
+void GraphicEngine::runWhileSimulationInView() {
   /**
-   * Visually outlines base 3 -> base 2 conversion by selecting
-   * the corresponding base 3 column and base 2 line.
+   * In LINE and COL modes, the east end of the edge moves west by at most
+   * one cell per step: the steps until it leaves the view are run at once.
    */
-  assert(world.inputType == LINE || world.inputType == COL);
-
-  // Heuristic bound to have all the necessary cells on the screen
-  for (int iStep = 0; iStep < 4 * world.inputStr.size(); iStep += 1)
-    world.next();
-
-  sf::Vector2i targetCell = {0, 0};
-  if (world.inputType == LINE) {
-    targetCell = {-1 * static_cast<int>(world.inputStr.size()), 0};
-    while (world.doesCellExists(targetCell) &&
-           world.doesCellExists(targetCell + SOUTH))
-      targetCell += SOUTH;
-  }
-
-  std::string base2Row, base3Col;
-  sf::Vector2i currentPos = targetCell + NORTH;
-
-  while (world.doesCellExists(currentPos)) {
-    base3Col += '0' + world.cells[currentPos].sum();
-    selectedCells[currentPos] = 0;
-    currentPos += NORTH;
+  if (world->inputType != LINE && world->inputType != COL) {
+    while (isSimulationInView())
+      world->next();
+    return;
   }
-  std::reverse(base3Col.begin(), base3Col.end());
-  unsigned long long int z3 = 0;
-  for (const auto &c : base3Col)
-    z3 = 3 * z3 + (c - '0');
-
-  // std::string computedBase2 = World::base32(base3Col);
-
-  currentPos = targetCell + WEST;
-  while (world.doesCellExists(currentPos)) {
-    base2Row += '0' + static_cast<char>(world.cells[currentPos].bit);
-    selectedCells[currentPos] = 0;
-    currentPos += WEST;
-  }
-
-  // Remove head 0s
-  currentPos += EAST;
-  while (world.doesCellExists(currentPos) &&
-         world.cells[currentPos].bit == ZERO) {
-
-    selectedCells.erase(currentPos);
-    base2Row.erase(base2Row.size() - 1);
-    currentPos += EAST;
+  int westX = getExtremalVisibleCellsPos().first.x;
+  while (isSimulationInView()) {
+    int eastX = INT_MIN;
+    for (const Vector2i &cellPos : world->cellsOnEdge)
+      eastX = MAX(eastX, cellPos.x);
+    world->advance(eastX - westX + 1);
   }
+}
 
-  std::reverse(base2Row.begin(), base2Row.end());
-  unsigned long long int z2 = 0;
-  for (const auto &c : base2Row)
-    z2 = 2 * z2 + (c - '0');
-
-  if (base2Row.size() > 64) {
-    printf("\nYou are considering > 64 bit strings which exceeds the precision "
-           "the numbers were computed with.\n");
-    printf("Hence the following numbers interpretations are false "
-           "(truncated).\n\n");
-  } else
-    printf("\n");
-  printf("The outlined vertical column is a base 3' encoding of: `%s` = %lld\n",
-         base3Col.c_str(), z3);
-  printf("The outlined horizontal row is a base 2 encoding of: `%s` = %lld\n",
-         base2Row.c_str(), z2);
-  if (base2Row.size() <= 64) {
-    printf("Both represent the number: %lld\n\n", z3);
+void GraphicEngine::outlineResult() {
+  /**
+   * Visually outlines base 3 -> base 2 conversion by selecting
+   * the corresponding base 3 column and base 2 line.
+   */
+  std::vector<Vector2i> outlinedCells;
+  Vector2i targetCell = world->printBaseConversion(outlinedCells);
+  int colSize = 0, rowSize = 0; // The column north of the target, the row west
+  for (const Vector2i &cellPos : outlinedCells) {
+    selectedCells[cellPos] = 0;
+    if (cellPos.x == targetCell.x)
+      colSize += 1;
+    else
+      rowSize += 1;
   }
   cameraCenter(mapWorldPosToCoords(targetCell));
 
@@ -288,13 +282,11 @@ void GraphicEngine::outlineResult() {
 
   int visibilityOffset = 2;
   while (
-      !isCellInView(targetCell +
-                    (base3Col.size() + visibilityOffset) * NORTH) ||
-      !isCellInView(targetCell + (base2Row.size() + visibilityOffset) * WEST))
+      !isCellInView(targetCell + (colSize + visibilityOffset) * NORTH) ||
+      !isCellInView(targetCell + (rowSize + visibilityOffset) * WEST))
     cameraZoom(1 / DEFAULT_CAM_ZOOM_STEP);
 
-  while (isSimulationInView())
-    world.next();
+  runWhileSimulationInView();
 }
 
 void GraphicEngine::handleTikzEvents(const sf::Event &event) {
@@ -339,6 +331,12 @@ void GraphicEngine::run() {
           break;
 
         case sf::Keyboard::A:
+          if (isAltPressed()) {
+            world->setProfiling(!world->getProfile().isEnabled);
+            printf("Profiling %s\n",
+                   world->getProfile().isEnabled ? "enabled" : "disabled");
+            break;
+          }
           // Not to clash with ctrl + A
           if (!isControlPressed()) {
             printf("FPS: %d\n", currentFPS);
@@ -346,7 +344,7 @@ void GraphicEngine::run() {
                    graphicCells[CELL_BACKGROUND].size(), VERTEX_ARRAY_MAX_SIZE);
             printf("Number of graphic cells (quads): %d\n",
                    totalGraphicBufferSize());
-            printf("Number of cells on edge: %ld\n", world.cellsOnEdge.size());
+            world->printStatistics();
             printf("Current zoom factor: %lf\n", currentZoom);
           }
           break;
@@ -385,50 +383,53 @@ void GraphicEngine::run() {
           break;
 
         case sf::Keyboard::N:
-          world.next();
+          world->next();
           break;
 
         case sf::Keyboard::M:
-          while (isSimulationInView())
-            world.next();
+          runWhileSimulationInView();
           break;
 
         case sf::Keyboard::Right:
           if (isAltPressed() &&
-              (world.inputType == CYCLE || world.inputType == BORDER)) {
-            reset();
-            world.rotate(1);
-            while (isSimulationInView())
-              world.next();
-          }
+              (world->inputType == CYCLE || world->inputType == BORDER))
+            rotate(1);
           break;
 
         case sf::Keyboard::Left:
           if (isAltPressed() &&
-              (world.inputType == CYCLE || world.inputType == BORDER)) {
-            reset();
-            world.rotate(-1);
-            while (isSimulationInView())
-              world.next();
-          }
+              (world->inputType == CYCLE || world->inputType == BORDER))
+            rotate(-1);
           break;
 
         case sf::Keyboard::P:
-          if (world.inputType == CYCLE) {
-            while (!world.isCycleDetected())
-              world.next();
-            // world.printCycleInformation();
-          } else if (world.inputType == BORDER) {
-            while (!world.isComputationDone())
-              world.next();
-          } else if (world.inputType == LINE || world.inputType == COL) {
+          // Closed forms are instant, with ALT the simulation first runs
+          // until it has computed them too
+          if (world->inputType == CYCLE) {
+            if (isAltPressed())
+              while (!world->isCycleDetected())
+                world->next();
+            world->printCycleInformation();
+          } else if (world->inputType == BORDER) {
+            if (isAltPressed())
+              while (!world->isComputationDone())
+                world->next();
+            world->printBorderInformation();
+          } else if (world->inputType == LINE || world->inputType == COL) {
             outlineResult();
           }
           break;
 
         case sf::Keyboard::R:
           reset();
-          world.reset();
+          world->reset();
+          break;
+
+        case sf::Keyboard::S:
+          if (snapshotPath.empty())
+            printf("Give a file with `--save-snapshot` to save snapshots.\n");
+          else
+            world->saveSnapshot(snapshotPath);
           break;
 
         default:
@@ -458,11 +459,11 @@ void GraphicEngine::run() {
       renderEdge();
 
     if (isParityVectorRendered &&
-        (world.inputType == BORDER || world.inputType == CYCLE))
+        (world->inputType == BORDER || world->inputType == CYCLE))
       renderParityVector();
 
     renderSelectedCells();
-    if (world.inputType == CYCLE)
+    if (world->inputType == CYCLE)
       renderSelectedBorder();
 
     if (isOriginRendered)
@@ -6,6 +6,7 @@
 #include <SFML/Window.hpp>
 
 #include "global.h"
+#include "rotation_sweep.h"
 #include "world.h"
 
 #define CELL_W 20
@@ -54,20 +55,24 @@ class GraphicEngine {
    */
 
 public:
-  GraphicEngine(World &world, int screen_w, int screen_h, bool isTikzEnabled);
+  GraphicEngine(World &world, int screen_w, int screen_h, bool isTikzEnabled,
+                const std::string &snapshotPath = "");
   ~GraphicEngine();
 
   void run();
 
 private:
-  World &world;
+  World *world; // Changes with the rotations of the parity vector
+  std::unique_ptr<RotationSweep> rotations; // Created at the first rotation
+  void rotate(int direction);
 
   sf::RenderWindow window;
 
   // General routines
-  sf::Vector2f mapWorldPosToCoords(const sf::Vector2i &world_coords);
-  sf::Vector2i mapCoordsToWorldPos(const sf::Vector2f &coords);
+  sf::Vector2f mapWorldPosToCoords(const Vector2i &world_coords);
+  Vector2i mapCoordsToWorldPos(const sf::Vector2f &coords);
   bool isSimulationInView();
+  void runWhileSimulationInView();
   bool isOriginRendered;
   bool isEdgeRendered;
   bool isParityVectorRendered;
@@ -85,9 +90,9 @@ private:
   sf::Texture fontTexture;
   sf::Vector2f getFontTextureCharCoords(char c, int i);
   // Rendering routines
-  void outlineCell(const sf::Vector2i &cellPos, sf::Color outlineColor);
-  void outlineCell(const sf::Vector2i &cellPos, sf::Color outlineColor,
-                   const sf::Vector2i &side);
+  void outlineCell(const Vector2i &cellPos, sf::Color outlineColor);
+  void outlineCell(const Vector2i &cellPos, sf::Color outlineColor,
+                   const Vector2i &side);
   void renderOrigin();
   void renderEdge();         // FIXME: Not optimized
   void renderParityVector(); // FIXME: Not optimized
@@ -102,8 +107,8 @@ private:
   void cameraZoom(float zoom_factor);
   void cameraCenter(const sf::Vector2f &where);
   bool isCellInView(
-      const sf::Vector2i &cellPos); // Cell pos is expressed in world positions
-  std::pair<sf::Vector2i, sf::Vector2i>
+      const Vector2i &cellPos); // Cell pos is expressed in world positions
+  std::pair<Vector2i, Vector2i>
   getExtremalVisibleCellsPos(); // In world positions
 
   // Event routines and handlers
@@ -114,44 +119,50 @@ private:
 
   // Graphic cells
   std::vector<sf::VertexArray> graphicCells[NB_LAYERS];
-  std::map<sf::Vector2i, std::pair<int, int>, compareWorldPositions>
+  FlatPosMap<std::pair<int, int>>
       vertexArrayCell[NB_LAYERS]; // Mapping world pos to where are the cell's
                                   // quad in `graphicCells`
+  std::vector<Vector2i> cellBuffer; // Cells sent by the world, reused
+  std::vector<Vector2i> evictedCellBuffer; // Streaming mode
   void updateGraphicCells();
   void initGraphicBuffers();
   void newGraphicBuffer(int iLayer);
-  void appendOrUpdateCell(const sf::Vector2i &cellPos, const Cell &cell);
+  void appendOrUpdateCell(const Vector2i &cellPos, const Cell &cell);
+  void removeCell(const Vector2i &cellPos);
   int totalGraphicBufferSize();
   sf::VertexArray &currentBuffer(int iLayer);
   bool hasBufferLimitExceeded(int iLayer);
-  std::vector<sf::Vertex> getCellBackgroundVertices(const sf::Vector2i &cellPos,
+  std::vector<sf::Vertex> getCellBackgroundVertices(const Vector2i &cellPos,
                                                     const Cell &cell);
-  std::vector<sf::Vertex> getCellColorVertices(const sf::Vector2i &cellPos,
+  std::vector<sf::Vertex> getCellColorVertices(const Vector2i &cellPos,
                                                const Cell &cell);
-  std::vector<sf::Vertex> getCellTextVertices(const sf::Vector2i &cellPos,
+  std::vector<sf::Vertex> getCellTextVertices(const Vector2i &cellPos,
                                               const Cell &cell);
   void reset();
 
   // Selected cells
-  std::map<sf::Vector2i, int, compareWorldPositions> selectedCells;
-  std::map<sf::Vector2i, int, compareWorldPositions> selectedBorder;
+  FlatPosMap<int> selectedCells;
+  FlatPosMap<int> selectedBorder;
   void renderSelectedCells();
   void renderSelectedBorder();
   void handleSelectorsEvents(const sf::Event &event);
-  void toggleSelectedCell(const sf::Vector2i &cellPos, bool onlyAdd = false,
+  void toggleSelectedCell(const Vector2i &cellPos, bool onlyAdd = false,
                           bool toggleParityVector = false);
-  void clearSelectedColor(const sf::Vector2i &cellPos);
+  void clearSelectedColor(const Vector2i &cellPos);
   int currentSelectedColor;
 
   // Tikz output: enables the user to select a rectangular
   // area to export to tikz
   bool isTikzEnabled;
   bool tikzMode;
-  std::vector<sf::Vector2i> tikzSelection; // Contains 0, 1 or 2 cells
-  sf::Vector2i tikzCursorPos;
+  std::vector<Vector2i> tikzSelection; // Contains 0, 1 or 2 cells
+  Vector2i tikzCursorPos;
   void renderTikzSelection();
-  std::string getTikzCell(const sf::Vector2i &cellPos, int maxX);
+  std::string getTikzCell(const Vector2i &cellPos, int maxX);
   void generateTikzFromSelection();
   void handleTikzEvents(const sf::Event &event);
   bool isTikzGridEnabled;
+
+  // Binary snapshot written when pressing S, empty if none
+  std::string snapshotPath;
 };
\ No newline at end of file
@@ -106,23 +106,23 @@ void GraphicEngine::handleCameraEvents(const sf::Event &event) {
     }
 }
 
-std::pair<sf::Vector2i, sf::Vector2i>
+std::pair<Vector2i, Vector2i>
 GraphicEngine::getExtremalVisibleCellsPos() {
   /***
    * Returns (topLeft,bottomRight) in world positions.
    */
 
   sf::Vector2f topLeftCoords = window.mapPixelToCoords({0, 0});
-  sf::Vector2i topLeftPos = mapCoordsToWorldPos(topLeftCoords);
+  Vector2i topLeftPos = mapCoordsToWorldPos(topLeftCoords);
 
   sf::Vector2f bottomRightCoords = window.mapPixelToCoords(
       {(int)window.getSize().x, (int)window.getSize().y});
-  sf::Vector2i bottomRightPos = mapCoordsToWorldPos(bottomRightCoords);
+  Vector2i bottomRightPos = mapCoordsToWorldPos(bottomRightCoords);
 
   return std::make_pair(topLeftPos, bottomRightPos);
 }
 
-bool GraphicEngine::isCellInView(const sf::Vector2i &cellPos) {
+bool GraphicEngine::isCellInView(const Vector2i &cellPos) {
   auto extremalVisibleCells = getExtremalVisibleCellsPos();
   auto topLeft = extremalVisibleCells.first;
   auto bottomRight = extremalVisibleCells.second;
@@ -1,6 +1,8 @@
 #include "../graphic_engine.h"
 
-void GraphicEngine::outlineCell(const sf::Vector2i &cellPos,
+#include <cmath>
+
+void GraphicEngine::outlineCell(const Vector2i &cellPos,
                                 sf::Color outlineColor) {
   /**
    * Outlines the border of a cell with the given `outlineColor`.
@@ -13,9 +15,9 @@ void GraphicEngine::outlineCell(const sf::Vector2i &cellPos,
   window.draw(carre);
 }
 
-void GraphicEngine::outlineCell(const sf::Vector2i &cellPos,
+void GraphicEngine::outlineCell(const Vector2i &cellPos,
                                 sf::Color outlineColor,
-                                const sf::Vector2i &side) {
+                                const Vector2i &side) {
   /**
    * Outlines the border of a cell with the given `outlineColor`.
    */
@@ -44,9 +46,9 @@ void GraphicEngine::renderOrigin() {
 
 void GraphicEngine::renderEdge() {
   /**
-   * Outline each cells on the edge of the world.
+   * Outline each cells on the edge of the world->
    */
-  for (const auto &cellPos : world.cellsOnEdge)
+  for (const auto &cellPos : world->cellsOnEdge)
     outlineCell(cellPos, COLOR_DARKER_GREEN);
 }
 
@@ -64,11 +66,11 @@ void GraphicEngine::renderSelectedBorder() {
    * In cyclic mode renders the parity vector beneath selected cells.
    */
   for (const auto &posAndColor : selectedBorder) {
-    sf::Vector2i currentPos = posAndColor.first - world.cyclicForwardVector;
+    Vector2i currentPos = posAndColor.first - world->cyclicForwardVector;
     // FIXME: should not have access to world inputStr, world should give
     // a public access to the step to take.
-    for (int i = 0; i < world.inputStr.length(); i++) {
-      const char &c = world.inputStr[i];
+    for (int i = 0; i < world->inputStr.length(); i++) {
+      const char &c = world->inputStr[i];
       outlineCell(currentPos,
 
                   SELECTED_CELLS_WHEEL[posAndColor.second], SOUTH);
@@ -113,7 +115,7 @@ int GraphicEngine::totalGraphicBufferSize() {
 }
 
 std::vector<sf::Vertex>
-GraphicEngine::getCellBackgroundVertices(const sf::Vector2i &cellPos,
+GraphicEngine::getCellBackgroundVertices(const Vector2i &cellPos,
                                          const Cell &cell) {
   /**
    * Constructs the vertices for the background of a cell (layer
@@ -139,7 +141,7 @@ GraphicEngine::getCellBackgroundVertices(const sf::Vector2i &cellPos,
 }
 
 std::vector<sf::Vertex>
-GraphicEngine::getCellColorVertices(const sf::Vector2i &cellPos,
+GraphicEngine::getCellColorVertices(const Vector2i &cellPos,
                                     const Cell &cell) {
   /**
    * Constructs the vertices for the color of a cell corresponding to the symbol
@@ -185,7 +187,7 @@ sf::Vector2f GraphicEngine::getFontTextureCharCoords(char c, int i) {
 }
 
 std::vector<sf::Vertex>
-GraphicEngine::getCellTextVertices(const sf::Vector2i &cellPos,
+GraphicEngine::getCellTextVertices(const Vector2i &cellPos,
                                    const Cell &cell) {
   /**
    * Constructs the vertices for the text inside a cell (layer `CELL_TEXT`).
@@ -246,7 +248,7 @@ GraphicEngine::getCellTextVertices(const sf::Vector2i &cellPos,
   return toRet;
 }
 
-void GraphicEngine::appendOrUpdateCell(const sf::Vector2i &cellPos,
+void GraphicEngine::appendOrUpdateCell(const Vector2i &cellPos,
                                        const Cell &cell) {
   /**
    * Adding or modifying a cell in the graphic buffer.
@@ -284,6 +286,33 @@ void GraphicEngine::appendOrUpdateCell(const sf::Vector2i &cellPos,
   }
 }
 
+void GraphicEngine::removeCell(const Vector2i &cellPos) {
+  /**
+   * Removing a cell from the graphic buffers: the quads of the last cell of
+   * its vertex array take its place.
+   */
+  for (int iLayer = 0; iLayer < NB_LAYERS; iLayer += 1) {
+    auto it = vertexArrayCell[iLayer].find(cellPos);
+    if (it == vertexArrayCell[iLayer].end())
+      continue;
+    sf::VertexArray &buffer = graphicCells[iLayer][it->second.first];
+    int iVertex = it->second.second;
+    int nbVertices = (iLayer == CELL_TEXT) ? NB_TEXT_QUADS : 4;
+    int iLastVertex = buffer.getVertexCount() - nbVertices;
+    if (iVertex != iLastVertex) {
+      // The first vertex of a cell is inside the cell
+      const sf::Vector2f &coords = buffer[iLastVertex].position;
+      Vector2i lastCellPos(std::floor(coords.x / CELL_W),
+                           std::floor(coords.y / CELL_H));
+      for (int i = 0; i < nbVertices; i += 1)
+        buffer[iVertex + i] = buffer[iLastVertex + i];
+      vertexArrayCell[iLayer][lastCellPos].second = iVertex;
+    }
+    buffer.resize(iLastVertex);
+    vertexArrayCell[iLayer].erase(cellPos);
+  }
+}
+
 sf::VertexArray &GraphicEngine::currentBuffer(int iLayer) {
   /**
    * Returns the graphic buffer currently in use on layer `iLayer`.
@@ -302,14 +331,18 @@ bool GraphicEngine::hasBufferLimitExceeded(int iLayer) {
 
 void GraphicEngine::updateGraphicCells() {
   /**
-   * Updates the graphic buffers with the information sent by the world.
+   * Updates the graphic buffers with the information sent by the world->
    */
-  std::vector<sf::Vector2i> cellBuffer = world.getAndFlushGraphicBuffer();
+  for (const Vector2i &cellPos : evictedCellBuffer)
+    removeCell(cellPos);
+  evictedCellBuffer.clear();
+
+  world->getAndFlushGraphicBuffer(cellBuffer);
   for (auto &cellPos : cellBuffer) {
     for (int iLayer = 0; iLayer < NB_LAYERS; iLayer += 1)
       if (hasBufferLimitExceeded(iLayer))
         newGraphicBuffer(iLayer);
-    appendOrUpdateCell(cellPos, world.cells[cellPos]);
+    appendOrUpdateCell(cellPos, world->cells[cellPos]);
   }
 }
 
@@ -318,7 +351,7 @@ void GraphicEngine::renderParityVector() {
    * Renders all cells on the input parity vector
    */
 
-  for (const auto &pos : world.parityVectorCells)
+  for (const auto &pos : world->parityVectorCells)
     outlineCell(pos, COLOR_PARITY_VECTOR);
 }
 
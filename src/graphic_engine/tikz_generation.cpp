@@ -18,7 +18,7 @@
 
 #define TIKZ_TEXT_COLOR "white"
 
-sf::Vector2f toTikzCoordinates(const sf::Vector2i &worldPos) {
+sf::Vector2f toTikzCoordinates(const Vector2i &worldPos) {
   /**
    * Tikz uses the mathematical convention of NORTH = increasing y.
    */
@@ -43,7 +43,7 @@ std::string tikzPreamble() {
   return preamble;
 }
 
-std::string GraphicEngine::getTikzCell(const sf::Vector2i &cellPos, int maxX) {
+std::string GraphicEngine::getTikzCell(const Vector2i &cellPos, int maxX) {
   /**
    * Get the tikz expression for the cell at coordinates x,y;
    * MaxX is given so the function can figure out if a state (\bot,\bot)
@@ -62,13 +62,13 @@ std::string GraphicEngine::getTikzCell(const sf::Vector2i &cellPos, int maxX) {
   bool drawSpecialStroke = false;
   // Sometimes the simulator says something is not defined
   // but in an ideal math world it is.
-  if (world.inputType == COL || world.inputType == LINE) {
-    if (!world.doesCellExists(cellPos)) {
-      sf::Vector2i pos = cellPos;
+  if (world->inputType == COL || world->inputType == LINE) {
+    if (!world->doesCellExists(cellPos)) {
+      Vector2i pos = cellPos;
       bool ideallyDefined = false;
       while (pos.x <= maxX) {
-        if (world.doesCellExists(pos)) {
-          if (world.cells[pos].getStatus() == HALF_DEFINED) {
+        if (world->doesCellExists(pos)) {
+          if (world->cells[pos].getStatus() == HALF_DEFINED) {
             ideallyDefined = false;
             break;
           }
@@ -84,18 +84,18 @@ std::string GraphicEngine::getTikzCell(const sf::Vector2i &cellPos, int maxX) {
     }
   }
 
-  if (world.doesCellExists(cellPos)) {
-    if (world.cells[cellPos].getStatus() == DEFINED) {
+  if (world->doesCellExists(cellPos)) {
+    if (world->cells[cellPos].getStatus() == DEFINED) {
       fillColor = TIKZ_FULLY_DEFINED_BG_NAME;
       strokeColor = TIKZ_FULLY_DEFINED_BG_NAME;
-      text = symbols[world.cells[cellPos].index() / 2];
+      text = symbols[world->cells[cellPos].index() / 2];
 
-      // if (world.cells[cellPos].index() == 0) {
-      //   sf::Vector2i pos = cellPos + WEST;
+      // if (world->cells[cellPos].index() == 0) {
+      //   Vector2i pos = cellPos + WEST;
       //   bool onlyNothingness = true;
-      //   while (world.doesCellExists(pos)) {
-      //     assert(world.cells[pos].getStatus() == DEFINED);
-      //     if (world.cells[pos].index() != 0)
+      //   while (world->doesCellExists(pos)) {
+      //     assert(world->cells[pos].getStatus() == DEFINED);
+      //     if (world->cells[pos].index() != 0)
       //       onlyNothingness = false;
       //     pos += WEST;
       //   }
@@ -106,7 +106,7 @@ std::string GraphicEngine::getTikzCell(const sf::Vector2i &cellPos, int maxX) {
     } else {
       fillColor = TIKZ_HALF_DEFINED_BG_NAME;
       strokeColor = TIKZ_HALF_DEFINED_BG_NAME;
-      int symbolIndex = static_cast<int>(world.cells[cellPos].bit);
+      int symbolIndex = static_cast<int>(world->cells[cellPos].bit);
       text = symbols[symbolIndex];
     }
 
@@ -118,8 +118,8 @@ std::string GraphicEngine::getTikzCell(const sf::Vector2i &cellPos, int maxX) {
   // Color
 
   if (isColorRendered) {
-    if (world.cells[cellPos].getStatus() == DEFINED) {
-      int i = world.cells[cellPos].index();
+    if (world->cells[cellPos].getStatus() == DEFINED) {
+      int i = world->cells[cellPos].index();
       std::string colorTikzArray[] = {"green", "black", "violet", "blue"};
       strokeColor = colorTikzArray[i];
       fillColor = colorTikzArray[i];
@@ -138,9 +138,9 @@ std::string GraphicEngine::getTikzCell(const sf::Vector2i &cellPos, int maxX) {
 
   // Carry
   float tweaky = -0.15;
-  if (world.doesCellExists(cellPos) && world.cells[cellPos].carry == ONE) {
+  if (world->doesCellExists(cellPos) && world->cells[cellPos].carry == ONE) {
     std::string carryColor = TIKZ_TEXT_COLOR;
-    if (world.cells[cellPos].isBootstrappingCarry)
+    if (world->cells[cellPos].isBootstrappingCarry)
       carryColor = TIKZ_BOOT_CARRY_NAME;
     stringStream << "\\draw [" << carryColor << ", ultra thick] "
                  << "(" << tikzCoord.x + 0.27;
@@ -173,8 +173,8 @@ void GraphicEngine::generateTikzFromSelection() {
 
   std::string tikzFileString = tikzPreamble();
 
-  sf::Vector2i posA = tikzSelection[0];
-  sf::Vector2i posB = tikzSelection[1];
+  Vector2i posA = tikzSelection[0];
+  Vector2i posB = tikzSelection[1];
 
   int minX, maxX, minY, maxY;
   minX = MIN(posA.x, posB.x);
@@ -184,7 +184,7 @@ void GraphicEngine::generateTikzFromSelection() {
 
   for (int x = minX; x <= maxX; x += 1)
     for (int y = minY; y <= maxY; y += 1) {
-      sf::Vector2i cellPos = {x, y};
+      Vector2i cellPos = {x, y};
       if (selectedCells.find(cellPos) == selectedCells.end())
         tikzFileString += getTikzCell({x, y}, maxX);
     }
@@ -196,11 +196,11 @@ void GraphicEngine::generateTikzFromSelection() {
         tikzFileString += getTikzCell(posAndColor.first, maxX);
 
   for (const auto &posAndColor : selectedBorder) {
-    sf::Vector2i currentPos = posAndColor.first - world.cyclicForwardVector;
+    Vector2i currentPos = posAndColor.first - world->cyclicForwardVector;
     // FIXME: should not have access to world inputStr, world should give
     // a public access to the step to take.
-    for (int i = 0; i < world.inputStr.length(); i++) {
-      const char &c = world.inputStr[i];
+    for (int i = 0; i < world->inputStr.length(); i++) {
+      const char &c = world->inputStr[i];
 
       std::string colorTikzName = TIKZ_SELECTED_CELLS_WHEEL[posAndColor.second];
       auto tikzCoord = toTikzCoordinates(currentPos);
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cell_store.h"
+#include "global.h"
+
+// Cells of the macro blocks are packed cells (see `cell_store.h`) plus this
+// flag, set when one of the contiguous cells east of the cell on its row has
+// a ONE bit. It is all the non local rule needs to know about the row
+#define MACRO_ONE_EAST_FLAG 16
+
+// Leaves are squares of 8 by 8 cells
+#define MACRO_LEAF_LEVEL 3
+#define MACRO_LEAF_SIDE (1 << MACRO_LEAF_LEVEL)
+
+// Past this number of blocks, the memoized ones are dropped before advancing
+static const size_t MAX_NB_MACRO_BLOCKS = 1 << 22;
+
+// Base blocks, of 2 by 2 leaves, are stepped cell by cell
+#define BASE_LEVEL (MACRO_LEAF_LEVEL + 1)
+#define BASE_SIDE (1 << BASE_LEVEL)
+
+typedef std::pair<Vector2i, uint8_t> MacroCell;
+typedef std::array<uint8_t, MACRO_LEAF_SIDE * MACRO_LEAF_SIDE> LeafCells;
+typedef uint8_t BaseGrid[BASE_SIDE][BASE_SIDE];
+
+struct MacroBlock {
+  /***
+   * Square of side 2^level of the quadtree. A block is canonical: two
+   * squares with the same cells are the same block.
+   */
+  uint32_t nw, ne, sw, se; // Children, `nw` is the leaf index at leaf level
+  int level;
+  bool hasHalfDefinedCells; // Blocks without any never change
+};
+
+struct MacroBlockKey {
+  uint32_t nw, ne, sw, se;
+  bool operator==(const MacroBlockKey &other) const {
+    return nw == other.nw && ne == other.ne && sw == other.sw &&
+           se == other.se;
+  }
+};
+
+struct MacroBlockKeyHash {
+  size_t operator()(const MacroBlockKey &key) const {
+    return TileKeyHash()(((static_cast<uint64_t>(key.nw) << 32) | key.ne) ^
+                         TileKeyHash()((static_cast<uint64_t>(key.sw) << 32) |
+                                       key.se));
+  }
+};
+
+struct LeafCellsHash {
+  size_t operator()(const LeafCells &cells) const {
+    uint64_t words[sizeof(LeafCells) / 8];
+    memcpy(words, cells.data(), sizeof(words));
+    uint64_t key = 0;
+    for (uint64_t word : words)
+      key = TileKeyHash()(key ^ word);
+    return static_cast<size_t>(key);
+  }
+};
+
+class MacroBlocks {
+  /***
+   * HashLife-style simulation of the LINE mode CA. The cells are a quadtree
+   * of canonical blocks and the future of the center of a block of side 2^k,
+   * 2^(k-3) steps later, is memoized: it only depends on the block since a
+   * cell reads at most 1 cell west, 2 cells east and 1 cell north of it per
+   * step. Repetitive regions, e.g. long runs of 0s, are then advanced in
+   * logarithmic time and blocks are shared from one `advance` to the next.
+   * The 0s the non local rule defines east of the bootstrapping carry are
+   * never read by the rules, they are left half defined for the caller to
+   * define.
+   */
+public:
+  MacroBlocks() : nbSteppedCells(0) { clear(); }
+
+  // Replaces `cells`, which contain every cell the rules can read, with the
+  // cells of the world `nbSteps` steps later
+  void advance(std::vector<MacroCell> &cells, int nbSteps);
+  size_t getNbBlocks() const { return blocks.size(); }
+  // Cells times steps actually computed, i.e. not found among the memoized
+  uint64_t getNbSteppedCells() const { return nbSteppedCells; }
+  void clear();
+
+private:
+  uint32_t leaf(const LeafCells &cells);
+  uint32_t join(uint32_t nw, uint32_t ne, uint32_t sw, uint32_t se);
+  uint32_t empty(int level);
+  void readBaseBlock(uint32_t block, BaseGrid &grid) const;
+  uint32_t leafAtCenter(const BaseGrid &grid);
+  uint32_t center(uint32_t block);
+  uint32_t result(uint32_t block, int log2NbSteps);
+  uint32_t stepBaseBlock(uint32_t block, int nbSteps);
+  uint32_t expand(uint32_t root);
+  bool isCentered(uint32_t root);
+
+  uint32_t build(const std::vector<MacroCell> &cells, Vector2i &origin);
+  void extract(uint32_t block, const Vector2i &origin,
+               std::vector<MacroCell> &cells);
+
+  std::vector<MacroBlock> blocks;
+  std::vector<LeafCells> leaves;
+  std::unordered_map<MacroBlockKey, uint32_t, MacroBlockKeyHash> blockIds;
+  std::unordered_map<LeafCells, uint32_t, LeafCellsHash> leafIds;
+  // Memoized futures, keyed on the block and the log2 of the steps
+  std::unordered_map<uint64_t, uint32_t, TileKeyHash> results;
+  std::vector<uint32_t> emptyBlocks; // Per level
+  uint64_t nbSteppedCells;
+};
@@ -1,18 +1,99 @@
 #include "config.h"
 
 #include "arguments.h"
-#include "graphic_engine.h"
+#include "batch.h"
 #include "world.h"
+#ifdef SIMCQCA_GUI
+#include "graphic_engine.h"
+#endif
 
+#include <chrono>
 #include <cstdio>
 
+static void runHeadless(World &world, const Arguments &arguments) {
+  /**
+   * Drives the world without a window, then prints what the A and P keys
+   * would print.
+   */
+  world.setGraphicBufferEnabled(false);
+  auto isRunOver = [&]() {
+    if (arguments.nbHeadlessSteps >= 0 &&
+        world.getNbSteps() >= arguments.nbHeadlessSteps)
+      return true;
+    if (arguments.isUntilCycle)
+      return world.isCycleDetected();
+    if (arguments.isUntilDone)
+      return world.isComputationDone();
+    return false;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  while (!isRunOver())
+    world.next();
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  printf("Steps: %d in %.3fs (%.1f steps/s)\n", world.getNbSteps(), seconds,
+         seconds > 0 ? world.getNbSteps() / seconds : 0);
+  world.printStatistics();
+  // Before the base conversion, which runs more steps
+  if (!arguments.saveSnapshotPath.empty())
+    world.saveSnapshot(arguments.saveSnapshotPath);
+  // The readouts walk cells that streaming may have evicted
+  if (world.isStreaming() && world.getNbEvictedCells() != 0)
+    printf("The result is not printed, cells it reads were evicted.\n");
+  else if (world.inputType == CYCLE)
+    world.printCycleInformation();
+  else if (world.inputType == BORDER)
+    world.printBorderInformation();
+  else {
+    std::vector<Vector2i> outlinedCells;
+    world.printBaseConversion(outlinedCells);
+  }
+}
+
 int main(int argc, char *argv[]) {
+  if (argc > 1 && std::string(argv[1]) == "batch") {
+    BatchArguments batchArguments;
+    parseBatchArguments(argc, argv, batchArguments);
+    runBatch(batchArguments);
+    return 0;
+  }
+
   Arguments arguments;
   parseArguments(argc, argv, arguments);
+#ifndef SIMCQCA_GUI
+  if (!arguments.isHeadless) {
+    printf("This build has no window (SIMCQCA_GUI is off), use `--%s`. "
+           "Abort.\n",
+           options[16].longOption);
+    return 0;
+  }
+#endif
 
   World world(arguments.isSequential, arguments.inputType, arguments.inputStr,
-              arguments.constructCycleInLine, arguments.cycleBoth);
+              arguments.constructCycleInLine, arguments.cycleBoth,
+              arguments.isFastEngineEnabled);
+  if (!arguments.outOfCorePath.empty())
+    world.cells.mapToFile(arguments.outOfCorePath,
+                          static_cast<size_t>(arguments.residentBudgetMB)
+                              << 20);
+  if (!arguments.loadSnapshotPath.empty())
+    world.loadSnapshot(arguments.loadSnapshotPath);
+  world.setNbThreads(arguments.nbThreads);
+  world.setProfiling(arguments.isProfiling);
+  world.setStreaming(arguments.streamingMargin);
+  if (!arguments.spillPath.empty())
+    world.spillEvictedCellsTo(arguments.spillPath);
+  if (arguments.isHeadless) {
+    runHeadless(world, arguments);
+    return 0;
+  }
+#ifdef SIMCQCA_GUI
   GraphicEngine graphicEngine(world, 800 * 1.5, 600 * 1.5,
-                              arguments.isTikzEnabled);
+                              arguments.isTikzEnabled,
+                              arguments.saveSnapshotPath);
   graphicEngine.run();
+#endif
 }
\ No newline at end of file
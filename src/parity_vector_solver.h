@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+
+#include "big_int.h"
+
+// Expansions of cycles stop looking for the end of their period after this
+// many digits
+#define MAX_EXPANSION_PERIOD 65536
+// Parity bits composed one by one at the leaves of the divide and conquer
+#define PARITY_BITS_PER_LEAF 64
+
+struct PAdicExpansion {
+  /***
+   * Eventually periodic p-adic expansion, least significant digit first:
+   * initialSegment (period)^inf.
+   */
+  std::string initialSegment;
+  std::string period;
+  bool isPeriodComplete; // False if longer than MAX_EXPANSION_PERIOD
+  char digitAt(size_t iDigit) const;
+};
+
+class ParityVectorSolver {
+  /***
+   * Closed forms of what the CA computes from a parity vector of n bits with
+   * k `1`s, for the Collatz map x -> x/2 or (3x+1)/2. Following the whole
+   * vector maps x to (3^k x + C) / 2^n where C is computed by divide and
+   * conquer on the vector, O(M(n) log n).
+   * - Cycle mode: the cycle is the rational C / (2^n - 3^k).
+   * - Border mode: the smallest x >= 0 following the vector is
+   *   -C / 3^k modulo 2^n, the inverse is a 2-adic Newton iteration.
+   */
+public:
+  explicit ParityVectorSolver(const std::string &parityVector);
+
+  // Cycle mode: numerator and denominator, the sign is apart
+  bool isCycleNegative() const { return isDenominatorNegative; }
+  const BigInt &getCycleNumerator() const { return c; }
+  const BigInt &getCycleDenominator() const { return denominator; }
+  PAdicExpansion expandCycle(uint32_t base) const; // 2 or 3
+
+  // Border mode: first and last number of the trajectory
+  BigInt getBorderInput() const;
+  BigInt getBorderOutput() const;
+
+private:
+  void compose(size_t iStart, size_t iEnd, BigInt &cPart,
+               BigInt &powerOf3Part) const;
+
+  std::string parityVector;
+  BigInt powerOf3; // 3^k
+  BigInt c;
+  BigInt denominator; // |2^n - 3^k|
+  bool isDenominatorNegative;
+};
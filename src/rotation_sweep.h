@@ -0,0 +1,76 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "world.h"
+
+// Worlds of rotations kept in memory, the world of rotation 0 not included
+#define DEFAULT_ROTATION_CACHE_SIZE 8
+
+struct ParityVectorResult {
+  /***
+   * What a border/cycle world computes from its parity vector, once its
+   * cycle is detected or its computation done.
+   */
+  uint64_t index; // Of the parity vector in batches, of the rotation in sweeps
+  std::string parityVector;
+  bool isResolved; // False if `maxSteps` steps were not enough
+  std::string row; // Most significant bit first
+  std::string col; // Border mode, most significant trit first
+  int64_t periodLength; // Cycle mode, -1 if not detected
+  size_t nbCells;
+  int nbSteps;
+  uint64_t timeMicroseconds;
+};
+
+// Runs `world` until its cycle is detected or its computation done
+void simulateUntilResolved(World &world, int maxSteps,
+                           ParityVectorResult &result);
+
+class RotationSweep {
+  /***
+   * All the rotations of the parity vector of a border/cycle world. Rotation
+   * r is the world of the input rotated r times with `World::rotate(1)`.
+   * Worlds of the rotations are computed concurrently and kept in a least
+   * recently used cache. The world given at construction is rotation 0, it
+   * is never evicted and still belongs to the caller.
+   */
+public:
+  RotationSweep(World &world, int nbThreads,
+                size_t cacheSize = DEFAULT_ROTATION_CACHE_SIZE);
+
+  int getNbRotations() const { return nbRotations; }
+  int getCurrentRotation() const { return currentRotation; }
+
+  // GUI: world of the current rotation moved by `direction`. If it is not
+  // cached, it is computed with the next rotations in that direction for
+  // as many steps as the world currently shown
+  World &rotate(int direction);
+
+  // Headless: every rotation until its cycle is detected or its computation
+  // done, results indexed by rotation
+  std::vector<ParityVectorResult> sweep(int maxSteps);
+
+private:
+  World &getCurrentWorld();
+  std::unique_ptr<World> take(int rotation); // NULL if not cached
+  void put(int rotation, std::unique_ptr<World> world);
+  std::unique_ptr<World> newWorld(int rotation);
+
+  World &baseWorld;
+  std::string baseInputStr;
+  int nbRotations;
+  int currentRotation;
+  size_t cacheSize;
+  std::unique_ptr<ThreadPool> threadPool;
+
+  typedef std::pair<int, std::unique_ptr<World>> CachedWorld;
+  std::list<CachedWorld> cache; // Most recently used first
+  std::unordered_map<int, std::list<CachedWorld>::iterator> cacheIndex;
+  std::mutex cacheMutex; // Sweeps put worlds from the pool threads
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cell_store.h"
+#include "global.h"
+
+struct PackedRow {
+  /***
+   * A fully computed row of the LINE mode world, stored as machine words.
+   * Bit i of `bits` is the bit of the cell at x = eastX - i. Carries are
+   * recomputed from the bits when the row is materialized.
+   */
+  std::vector<uint64_t> bits;
+  int y;
+  int eastX;    // Easternmost cell of the row
+  int westX;    // Westernmost cell of the row
+  int lastOneX; // Rightmost ONE bit, the bootstrapping carry is east of it
+};
+
+class RowEngine {
+  /***
+   * Fast engine for LINE mode. Each row is the next odd Collatz iterate of
+   * the previous one, so rows are computed with word arithmetic (3x+1 then
+   * trailing 0s stripping) instead of cell by cell. The cells of a row,
+   * carries included, are only produced on demand by `materializeRow` and
+   * are identical to the ones the CA rule computes.
+   */
+public:
+  RowEngine() : nbRows(0) {}
+  explicit RowEngine(const std::string &inputRow);
+
+  void next();               // Computes one more row
+  void advance(int nbSteps); // Computes `nbSteps` more rows
+  int getNbRows() const { return nbRows; }
+  const PackedRow &getRow(int y) const;
+  std::string getRowString(int y) const; // Big endian, without leading 0s
+  void materializeRow(int y,
+                      std::vector<std::pair<Vector2i, Cell>> &out) const;
+  void forgetRowsBefore(int y); // Frees rows which are not needed anymore
+
+private:
+  void completeRow(PackedRow &row, int westStart);
+
+  std::deque<PackedRow> rows;      // Computed rows not forgotten yet
+  std::vector<uint64_t> nextValue; // 3x+1 of the last row, bit 0 at its
+                                   // lastOneX
+  int nbRows;
+
+  // Scratch buffers of `completeRow`, kept from one row to the next
+  std::vector<uint64_t> odd, carries, carryIn;
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Per phase timing and counters of the simulation steps. Compiled in with
+ * SIMCQCA_PROFILING (the default CMake configuration) and, at runtime, only
+ * recorded once enabled with `World::setProfiling`.
+ */
+
+enum StepPhase {
+  PHASE_OTHER = 0, // Time of the steps spent outside of the other phases
+  PHASE_NON_LOCAL,
+  PHASE_CARRY_PROPAGATION,
+  PHASE_FORWARD_DEDUCTION,
+  PHASE_BACKWARD_DEDUCTION,
+  PHASE_CYCLIC,
+  PHASE_APPLY_UPDATES,
+  PHASE_CLEAN_EDGE,
+  PHASE_SEQUENTIAL,
+  PHASE_FAST_ENGINE,
+  PHASE_EVICTION,
+  PHASE_MACRO_BLOCKS,
+  NB_STEP_PHASES,
+  NO_PHASE = NB_STEP_PHASES
+};
+
+#ifdef SIMCQCA_PROFILING
+static const bool IS_PROFILING_COMPILED = true;
+#else
+static const bool IS_PROFILING_COMPILED = false;
+#endif
+
+struct StepProfile {
+  /***
+   * Phases nest, e.g. applying updates during the sequential worklist: the
+   * time of a phase excludes the phases nested in it, so that the times of
+   * all the phases add up to the time of the steps.
+   */
+  bool isEnabled;
+  uint64_t nanoseconds[NB_STEP_PHASES];
+  uint64_t nbCalls[NB_STEP_PHASES];
+  uint64_t nbUpdates[NB_STEP_PHASES]; // Found, applied or removed cells
+
+  // Sampled at the end of each step
+  uint64_t nbSteps;
+  size_t edgeSize, peakEdgeSize;
+  uint64_t totalEdgeSize; // Over all the steps, for the mean
+  size_t nbCells, peakNbCells; // The fast engines write their cells lazily
+
+  // Phase being timed, the one it is nested in is restored when it ends
+  StepPhase activePhase;
+  std::chrono::steady_clock::time_point activeSince;
+
+  StepProfile() : isEnabled(false) { clear(); }
+
+  void clear(); // Keeps `isEnabled`
+  void addUpdates(StepPhase phase, size_t nbPhaseUpdates) {
+    if (isEnabled)
+      nbUpdates[phase] += nbPhaseUpdates;
+  }
+  void endSteps(int nbEndedSteps, size_t edgeSize, size_t nbCells);
+  void print() const;
+};
+
+class PhaseTimer {
+  /***
+   * Times a phase from its construction to `stop` or its destruction.
+   */
+public:
+  PhaseTimer(StepProfile &profile, StepPhase phase)
+      : profile(profile), phase(phase), parentPhase(NO_PHASE),
+        isRunning(profile.isEnabled) {
+    if (!isRunning)
+      return;
+    auto now = std::chrono::steady_clock::now();
+    parentPhase = profile.activePhase;
+    if (parentPhase != NO_PHASE)
+      profile.nanoseconds[parentPhase] += elapsed(now);
+    profile.activePhase = phase;
+    profile.activeSince = now;
+    profile.nbCalls[phase] += 1;
+  }
+  ~PhaseTimer() { stop(); }
+
+  void stop() {
+    if (!isRunning)
+      return;
+    isRunning = false;
+    auto now = std::chrono::steady_clock::now();
+    profile.nanoseconds[phase] += elapsed(now);
+    profile.activePhase = parentPhase;
+    profile.activeSince = now;
+  }
+
+private:
+  uint64_t elapsed(std::chrono::steady_clock::time_point now) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               now - profile.activeSince)
+        .count();
+  }
+
+  StepProfile &profile;
+  StepPhase phase;
+  StepPhase parentPhase;
+  bool isRunning;
+};
+
+// Used in World methods, on its `profile`
+#ifdef SIMCQCA_PROFILING
+#define PROFILE_PHASE(phase) PhaseTimer phaseTimer(profile, phase)
+#define PROFILE_UPDATES(phase, nbUpdates) profile.addUpdates(phase, nbUpdates)
+#define PROFILE_END_STEPS(nbEndedSteps)                                        \
+  profile.endSteps(nbEndedSteps, cellsOnEdge.size(), cells.size())
+#else
+#define PROFILE_PHASE(phase)
+#define PROFILE_UPDATES(phase, nbUpdates)
+#define PROFILE_END_STEPS(nbEndedSteps)
+#endif
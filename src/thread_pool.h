@@ -0,0 +1,34 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+  /***
+   * Fixed set of worker threads running one batch of tasks at a time. The
+   * calling thread takes part in the batch and `run` returns once every task
+   * of the batch is done.
+   */
+public:
+  explicit ThreadPool(int nbThreads);
+  ~ThreadPool();
+
+  int getNbThreads() const { return nbThreads; }
+  // Runs task(0) to task(nbTasks - 1), in any order
+  void run(int nbTasks, const std::function<void(int)> &task);
+
+private:
+  void work();
+
+  int nbThreads; // Workers plus the calling thread
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable isTaskReady;
+  std::condition_variable isBatchDone;
+  const std::function<void(int)> *task; // NULL between batches
+  int nbTasks, nextTask, nbTasksDone;
+  bool isStopping;
+};
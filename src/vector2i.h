@@ -0,0 +1,48 @@
+#pragma once
+
+struct Vector2i {
+  /***
+   * Position of a cell in the world, x grows to the east and y to the south.
+   * The simulation core uses it instead of `sf::Vector2i` so that it does not
+   * depend on SFML, the graphic engine maps it to SFML coordinates.
+   */
+  int x, y;
+
+  Vector2i() : x(0), y(0) {}
+  Vector2i(int x, int y) : x(x), y(y) {}
+
+  Vector2i &operator+=(const Vector2i &other) {
+    x += other.x;
+    y += other.y;
+    return *this;
+  }
+  Vector2i &operator-=(const Vector2i &other) {
+    x -= other.x;
+    y -= other.y;
+    return *this;
+  }
+};
+
+static inline Vector2i operator-(const Vector2i &vector) {
+  return Vector2i(-vector.x, -vector.y);
+}
+
+static inline Vector2i operator+(const Vector2i &left, const Vector2i &right) {
+  return Vector2i(left.x + right.x, left.y + right.y);
+}
+
+static inline Vector2i operator-(const Vector2i &left, const Vector2i &right) {
+  return Vector2i(left.x - right.x, left.y - right.y);
+}
+
+static inline Vector2i operator*(int scalar, const Vector2i &vector) {
+  return Vector2i(scalar * vector.x, scalar * vector.y);
+}
+
+static inline bool operator==(const Vector2i &left, const Vector2i &right) {
+  return left.x == right.x && left.y == right.y;
+}
+
+static inline bool operator!=(const Vector2i &left, const Vector2i &right) {
+  return !(left == right);
+}
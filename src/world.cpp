@@ -1,72 +1,99 @@
 #include "world.h"
 
-std::vector<CellPosAndCell> World::findCarryPropUpdates() {
-  std::vector<CellPosAndCell> toRet;
-  for (const sf::Vector2i &cellPos : cellsOnEdge) {
-    assert(doesCellExists(cellPos));
-    if (cells[cellPos].getStatus() != HALF_DEFINED)
-      continue;
-    if (doesCellExists(cellPos + EAST) &&
-        cells[cellPos + EAST].getStatus() == DEFINED) {
-      AtomicInfo bit = cells[cellPos].bit;
-      AtomicInfo newCarry =
-          static_cast<AtomicInfo>((bit + cells[cellPos + EAST].sum()) >= 2);
-      Cell updatedCell = Cell(bit, newCarry);
-      toRet.push_back(std::make_pair(cellPos, updatedCell));
-
-      // Because we do a finite simulation of an infinite process
-      // we have some edge cases to deal with.
-      manageEdgeCases(toRet, cellPos, updatedCell);
-    }
+const std::vector<CellPosAndCell> &World::findCarryPropUpdates() {
+  PROFILE_PHASE(PHASE_CARRY_PROPAGATION);
+  findEdgeUpdates(&World::findCarryPropUpdate, carryPropUpdates);
+  PROFILE_UPDATES(PHASE_CARRY_PROPAGATION, carryPropUpdates.size());
+  return carryPropUpdates;
+}
+
+void World::findCarryPropUpdate(const Vector2i &cellPos,
+                                std::vector<CellPosAndCell> &toRet) {
+  assert(doesCellExists(cellPos));
+  if (cells[cellPos].getStatus() != HALF_DEFINED)
+    return;
+  if (doesCellExists(cellPos + EAST) &&
+      cells[cellPos + EAST].getStatus() == DEFINED) {
+    AtomicInfo bit = cells[cellPos].bit;
+    AtomicInfo newCarry =
+        static_cast<AtomicInfo>((bit + cells[cellPos + EAST].sum()) >= 2);
+    Cell updatedCell = Cell(bit, newCarry);
+    toRet.push_back(std::make_pair(cellPos, updatedCell));
+
+    // Because we do a finite simulation of an infinite process
+    // we have some edge cases to deal with.
+    manageEdgeCases(toRet, cellPos, updatedCell);
   }
-  return toRet;
 }
 
-std::vector<CellPosAndCell> World::findForwardDeductionUpdates() {
-  std::vector<CellPosAndCell> toRet;
-  for (const sf::Vector2i &cellPos : cellsOnEdge) {
-    assert(doesCellExists(cellPos) &&
-           cells[cellPos].getStatus() == HALF_DEFINED);
-    if (doesCellExists(cellPos + EAST) &&
-        cells[cellPos + EAST].getStatus() == DEFINED) {
-      AtomicInfo southBit = static_cast<AtomicInfo>(
-          (static_cast<int>(cells[cellPos].bit) + cells[cellPos + EAST].sum()) %
-          2);
-      toRet.push_back(std::make_pair(cellPos + SOUTH, Cell(southBit, UNDEF)));
-    }
+const std::vector<CellPosAndCell> &World::findForwardDeductionUpdates() {
+  PROFILE_PHASE(PHASE_FORWARD_DEDUCTION);
+  findEdgeUpdates(&World::findForwardDeductionUpdate, deductionUpdates);
+  PROFILE_UPDATES(PHASE_FORWARD_DEDUCTION, deductionUpdates.size());
+  return deductionUpdates;
+}
+
+void World::findForwardDeductionUpdate(const Vector2i &cellPos,
+                                       std::vector<CellPosAndCell> &toRet) {
+  assert(doesCellExists(cellPos) &&
+         cells[cellPos].getStatus() == HALF_DEFINED);
+  if (doesCellExists(cellPos + EAST) &&
+      cells[cellPos + EAST].getStatus() == DEFINED) {
+    AtomicInfo southBit = static_cast<AtomicInfo>(
+        (static_cast<int>(cells[cellPos].bit) + cells[cellPos + EAST].sum()) %
+        2);
+    toRet.push_back(std::make_pair(cellPos + SOUTH, Cell(southBit, UNDEF)));
   }
-  return toRet;
 }
 
-std::vector<CellPosAndCell> World::findBackwardDeductionUpdates() {
-  std::vector<CellPosAndCell> toRet;
-  for (const sf::Vector2i &cellPos : cellsOnEdge) {
-    assert(doesCellExists(cellPos));
-    if (!doesCellExists(cellPos + NORTH) &&
-        doesCellExists(cellPos + NORTH + EAST) &&
-        cells[cellPos + NORTH + EAST].getStatus() == DEFINED) {
-      AtomicInfo northBit =
-          static_cast<AtomicInfo>((cells[cellPos + NORTH + EAST].sum()) % 2 !=
-                                  static_cast<int>(cells[cellPos].bit));
-      toRet.push_back(std::make_pair(cellPos + NORTH, Cell(northBit, UNDEF)));
-    }
+const std::vector<CellPosAndCell> &World::findBackwardDeductionUpdates() {
+  PROFILE_PHASE(PHASE_BACKWARD_DEDUCTION);
+  findEdgeUpdates(&World::findBackwardDeductionUpdate, deductionUpdates);
+  PROFILE_UPDATES(PHASE_BACKWARD_DEDUCTION, deductionUpdates.size());
+  return deductionUpdates;
+}
+
+void World::findBackwardDeductionUpdate(const Vector2i &cellPos,
+                                        std::vector<CellPosAndCell> &toRet) {
+  assert(doesCellExists(cellPos));
+  if (!doesCellExists(cellPos + NORTH) &&
+      doesCellExists(cellPos + NORTH + EAST) &&
+      cells[cellPos + NORTH + EAST].getStatus() == DEFINED) {
+    AtomicInfo northBit =
+        static_cast<AtomicInfo>((cells[cellPos + NORTH + EAST].sum()) % 2 !=
+                                static_cast<int>(cells[cellPos].bit));
+    toRet.push_back(std::make_pair(cellPos + NORTH, Cell(northBit, UNDEF)));
   }
-  return toRet;
 }
 
 void World::cleanCellsOnEdge() {
   /**
    * Remove the cells which are not anymore on edge from the edge.
+   * Only the cells whose neighbourhood was touched since the last cleaning
+   * can have left the edge, unless a ONE bit was erased in which case the
+   * trailing 0s of the whole row must be re-examined.
    */
-  std::vector<sf::Vector2i> toRemove;
-  for (const auto &cellPos : cellsOnEdge)
-    if (!isCellOnEdge(cellPos))
-      toRemove.push_back(cellPos);
+  PROFILE_PHASE(PHASE_CLEAN_EDGE);
+  std::vector<Vector2i> &toRemove = edgeToRemove;
+  toRemove.clear();
+  if (isFullEdgeCleanNeeded) {
+    for (const auto &cellPos : cellsOnEdge)
+      if (!isCellOnEdge(cellPos))
+        toRemove.push_back(cellPos);
+  } else {
+    for (const auto &cellPos : edgeCandidates)
+      if (cellsOnEdge.find(cellPos) != cellsOnEdge.end() &&
+          !isCellOnEdge(cellPos))
+        toRemove.push_back(cellPos);
+  }
   for (const auto &cellPos : toRemove)
     cellsOnEdge.erase(cellPos);
+  PROFILE_UPDATES(PHASE_CLEAN_EDGE, toRemove.size());
+  edgeCandidates.clear();
+  isFullEdgeCleanNeeded = false;
 }
 
-bool World::isCellOnEdge(const sf::Vector2i &cellPos) {
+bool World::isCellOnEdge(const Vector2i &cellPos) {
   /**
    *  Determines whether a cell is on the edge of the computing region or not.
    */
@@ -87,12 +114,7 @@ bool World::isCellOnEdge(const sf::Vector2i &cellPos) {
     bool isTrailingZero = true;
     if (cells[cellPos].bit == ZERO && doesCellExists(cellPos + WEST) &&
         cells[cellPos + WEST].getStatus() == HALF_DEFINED) {
-      sf::Vector2i pos = cellPos + EAST;
-      while (doesCellExists(pos)) {
-        if (cells[pos].bit == ONE)
-          isTrailingZero = false;
-        pos += EAST;
-      }
+      isTrailingZero = !isThereOneEastOf(cellPos);
     } else {
       isTrailingZero = false;
     }
@@ -110,19 +132,94 @@ bool World::isCellOnEdge(const sf::Vector2i &cellPos) {
   return false;
 }
 
+void World::updateRowSummary(const Vector2i &cellPos, bool wasPresent,
+                             AtomicInfo oldBit, AtomicInfo newBit) {
+  /**
+   * Keeps the summary of the row of `cellPos` up to date after a write.
+   */
+  RowSummary &row = rowSummaries[cellPos.y];
+  if (!wasPresent) {
+    row.nbCells += 1;
+    row.minX = MIN(row.minX, cellPos.x);
+    row.maxX = MAX(row.maxX, cellPos.x);
+  }
+  if (newBit == ONE) {
+    row.rightmostOne = MAX(row.rightmostOne, cellPos.x);
+  } else if (oldBit == ONE && cellPos.x == row.rightmostOne) {
+    // Should not happen in practice: look for the previous ONE
+    row.rightmostOne = INT_MIN;
+    for (int x = cellPos.x - 1; x >= row.minX; x -= 1)
+      if (cells[{x, cellPos.y}].bit == ONE) {
+        row.rightmostOne = x;
+        break;
+      }
+  }
+}
+
+bool World::isThereOneEastOf(const Vector2i &cellPos) {
+  /**
+   * Is there a ONE bit on the contiguous cells east of `cellPos`?
+   */
+  const auto it = rowSummaries.find(cellPos.y);
+  if (it == rowSummaries.end())
+    return false;
+  const RowSummary &row = it->second;
+  if (row.isContiguous())
+    return row.rightmostOne > cellPos.x;
+
+  // Holes in the row: walk to the first one
+  Vector2i pos = cellPos + EAST;
+  while (doesCellExists(pos)) {
+    if (cells[pos].bit == ONE)
+      return true;
+    pos += EAST;
+  }
+  return false;
+}
+
 void World::applyUpdates(const std::vector<CellPosAndCell> &updates) {
+  PROFILE_PHASE(PHASE_APPLY_UPDATES);
+  PROFILE_UPDATES(PHASE_APPLY_UPDATES, updates.size());
+  // The sequential simulation of LINE/COL mode takes its worklist as edge
+  bool isEdgeTracked =
+      !isSequentialSim || inputType == BORDER || inputType == CYCLE;
   for (const auto &info : updates) {
-    const sf::Vector2i &cellPos = info.first;
+    const Vector2i &cellPos = info.first;
     const Cell &cell = info.second;
-    cells[cellPos] = cell;
-    cellGraphicBuffer.push_back(cellPos);
+    const Cell oldCell = cells[cellPos];
+    bool wasPresent = doesCellExists(cellPos);
+    if (inputType == LINE || inputType == COL)
+      if (oldCell.bit == ONE && cell.bit != ONE)
+        isFullEdgeCleanNeeded = true;
+    cells.set(cellPos, cell);
+    if (inputType == CYCLE && (oldCell.getStatus() == DEFINED) !=
+                                  (cell.getStatus() == DEFINED))
+      updateCyclicCutCounters(cellPos, cell.getStatus() == DEFINED ? 1 : -1);
+    updateRowSummary(cellPos, wasPresent, oldCell.bit, cell.bit);
+    if (inputType == COL)
+      updateColSummary(cellPos, wasPresent, oldCell, cell);
+    if (isGraphicBufferEnabled)
+      cellGraphicBuffer.push_back(cellPos);
+    if (!isEdgeTracked)
+      continue;
     if (isCellOnEdge(cellPos))
       cellsOnEdge.insert(cellPos);
     if (inputType == LINE || inputType == COL)
       if (isCellOnEdge(cellPos + WEST))
         cellsOnEdge.insert(cellPos + WEST);
+
+    // Whether a cell is on edge only depends on itself and its direct
+    // neighbours (plus the bits east of it in LINE/COL mode, see above)
+    edgeCandidates.push_back(cellPos);
+    if (inputType == LINE || inputType == COL) {
+      edgeCandidates.push_back(cellPos + WEST);
+      edgeCandidates.push_back(cellPos + EAST);
+    } else {
+      edgeCandidates.push_back(cellPos + SOUTH);
+    }
   }
-  cleanCellsOnEdge();
+  if (isEdgeTracked)
+    cleanCellsOnEdge();
 }
 
 void World::nextLocal() {
@@ -136,8 +233,8 @@ void World::nextLocal() {
     // First find the update then apply them
     // Do not apply some updates before they were all found
     // That would break the CA logic
-    auto carryPropUpdates = findCarryPropUpdates();
-    auto forwardDeductionUpdates = findForwardDeductionUpdates();
+    const auto &carryPropUpdates = findCarryPropUpdates();
+    const auto &forwardDeductionUpdates = findForwardDeductionUpdates();
     applyUpdates(carryPropUpdates);
     applyUpdates(forwardDeductionUpdates);
   }
@@ -145,8 +242,8 @@ void World::nextLocal() {
   // In BORDER/CYCLE mode, the local rule is
   // carry propagation followed by backward deduction
   if (inputType == BORDER || inputType == CYCLE) {
-    auto carryPropUpdates = findCarryPropUpdates();
-    auto backwardDeductionUpdates = findBackwardDeductionUpdates();
+    const auto &carryPropUpdates = findCarryPropUpdates();
+    const auto &backwardDeductionUpdates = findBackwardDeductionUpdates();
 
     applyUpdates(carryPropUpdates);
     applyUpdates(backwardDeductionUpdates);
@@ -154,10 +251,8 @@ void World::nextLocal() {
     // In cycle mode we need to enforce the equivalence relation on
     // cells of the world in order to compute
     if (inputType == CYCLE) {
-      auto cyclicUpdates = findCyclicUpdates(carryPropUpdates);
-      applyUpdates(cyclicUpdates);
-      cyclicUpdates = findCyclicUpdates(backwardDeductionUpdates);
-      applyUpdates(cyclicUpdates);
+      applyUpdates(findCyclicUpdates(carryPropUpdates));
+      applyUpdates(findCyclicUpdates(backwardDeductionUpdates));
     }
     // Tweak to get the right amount of 0s on the south
     // Deprecated
@@ -167,91 +262,246 @@ void World::nextLocal() {
 }
 
 void World::next() {
-  nextNonLocal();
-  nextLocal();
+  PROFILE_PHASE(PHASE_OTHER);
+  if (isFastEngineEnabled) {
+    PROFILE_PHASE(PHASE_FAST_ENGINE);
+    if (inputType == COL)
+      colEngine.next();
+    else
+      rowEngine.next();
+    updateFastEngineEdge();
+  } else {
+    size_t capacity = getBuffersCapacity();
+    if (isSequentialSim) {
+      nextSequential();
+    } else {
+      nextNonLocal();
+      nextLocal();
+    }
+    if (getBuffersCapacity() != capacity)
+      nbBufferAllocations += 1;
+  }
+  if (isStreaming())
+    evictFarCellsIfNeeded();
+  nbSteps += 1;
+  PROFILE_END_STEPS(1);
+}
+
+void World::findEdgeUpdates(CellRule findUpdate,
+                            std::vector<CellPosAndCell> &toRet) {
+  /**
+   * Applies `findUpdate` to every cell of the edge. Rules only read the
+   * world, so on a large edge chunks of it are scanned in parallel. The
+   * updates of the chunks are concatenated in chunk order: `toRet` is the
+   * same as with a single thread.
+   */
+  toRet.clear();
+  if (!threadPool || cellsOnEdge.size() < MIN_EDGE_SIZE_PARALLEL_FIND) {
+    for (const Vector2i &cellPos : cellsOnEdge)
+      (this->*findUpdate)(cellPos, toRet);
+    return;
+  }
+
+  int nbChunks = NB_CHUNKS_PER_THREAD * threadPool->getNbThreads();
+  size_t nbSlots = cellsOnEdge.getNbSlots();
+  chunkUpdates.resize(nbChunks);
+  threadPool->run(nbChunks, [&](int iChunk) {
+    std::vector<CellPosAndCell> &chunk = chunkUpdates[iChunk];
+    chunk.clear();
+    size_t firstSlot = nbSlots * iChunk / nbChunks;
+    size_t endSlot = nbSlots * (iChunk + 1) / nbChunks;
+    Poset::iterator end = cellsOnEdge.iteratorAt(endSlot);
+    for (Poset::iterator it = cellsOnEdge.iteratorAt(firstSlot); it != end;
+         ++it)
+      (this->*findUpdate)(*it, chunk);
+  });
+  for (const auto &chunk : chunkUpdates)
+    toRet.insert(toRet.end(), chunk.begin(), chunk.end());
+}
+
+void World::setProfiling(bool isEnabled) {
+  profile.isEnabled = isEnabled && IS_PROFILING_COMPILED;
+  profile.clear();
 }
 
-std::vector<CellPosAndCell> World::findNonLocalUpdates() {
+void World::setNbThreads(int nbThreads) {
+  if (nbThreads > 1)
+    threadPool.reset(new ThreadPool(nbThreads));
+  else
+    threadPool.reset();
+}
+
+void World::advance(int nbSteps) {
+  /**
+   * Runs `nbSteps` simulation steps. The fast engines compute all of them
+   * before the edge is updated, once. The LINE mode CA runs them by chunks,
+   * on memoized macro blocks.
+   */
+  if (isFastEngineEnabled) {
+    PROFILE_PHASE(PHASE_FAST_ENGINE);
+    if (inputType == COL)
+      colEngine.advance(nbSteps);
+    else
+      rowEngine.advance(nbSteps);
+    updateFastEngineEdge();
+    if (isStreaming())
+      evictFarCellsIfNeeded();
+    this->nbSteps += nbSteps;
+    PROFILE_END_STEPS(nbSteps);
+    return;
+  }
+  if (inputType == LINE && !isSequentialSim && !isStreaming()) {
+    /**
+     * Chaotic regions are rarely found again among the memoized blocks: the
+     * steps are run by chunks of growing size and, as soon as the blocks of
+     * a chunk compute too many cells for the cells it created, the
+     * remaining steps are run one by one.
+     */
+    int nbChunkSteps = MIN_MACRO_BLOCK_STEPS;
+    while (nbSteps >= MIN_MACRO_BLOCK_STEPS) {
+      nbChunkSteps = MIN(nbChunkSteps, nbSteps);
+      size_t nbCells = cells.size();
+      uint64_t nbSteppedCells = macroBlocks.getNbSteppedCells();
+      advanceByMacroBlocks(nbChunkSteps);
+      nbSteps -= nbChunkSteps;
+      nbSteppedCells = macroBlocks.getNbSteppedCells() - nbSteppedCells;
+      if (nbSteppedCells > MACRO_BLOCK_WARM_UP_CELLS +
+                               MAX_MACRO_BLOCK_CELLS_PER_NEW_CELL *
+                                   (cells.size() - nbCells))
+        break;
+      nbChunkSteps *= 2;
+    }
+  }
+  for (int iStep = 0; iStep < nbSteps; iStep += 1)
+    next();
+}
+
+size_t World::getBuffersCapacity() const {
+  size_t capacity = nonLocalUpdates.capacity() + carryPropUpdates.capacity() +
+                    deductionUpdates.capacity() + cyclicUpdates.capacity() +
+                    edgeToRemove.capacity() + edgeCandidates.capacity() +
+                    sequentialUpdates.capacity() + erasedOnes.capacity();
+  for (const auto &chunk : chunkUpdates)
+    capacity += chunk.capacity();
+  return capacity;
+}
+
+const std::vector<CellPosAndCell> &World::findNonLocalUpdates() {
   /**
    * Finding candidate cells for applying the non-local rule of the 2D CQCA.
    */
-  std::vector<CellPosAndCell> toRet;
-  for (const sf::Vector2i &cellPos : cellsOnEdge) {
+  PROFILE_PHASE(PHASE_NON_LOCAL);
+  findEdgeUpdates(&World::findNonLocalUpdate, nonLocalUpdates);
+  PROFILE_UPDATES(PHASE_NON_LOCAL, nonLocalUpdates.size());
+  return nonLocalUpdates;
+}
 
-    if (inputType == CYCLE && !constructCycleInLine)
-      if (cellPos.x == ORIGIN_BORDER_MODE.x)
-        continue;
+void World::findNonLocalUpdate(const Vector2i &cellPos,
+                               std::vector<CellPosAndCell> &toRet) {
+  if (inputType == CYCLE && !constructCycleInLine)
+    if (cellPos.x == ORIGIN_BORDER_MODE.x)
+      return;
 
-    assert(doesCellExists(cellPos));
+  assert(doesCellExists(cellPos));
 
-    // Detect if bootstrapping needed
-    if (cells[cellPos].bit == ONE) {
+  // Detect if bootstrapping needed
+  if (cells[cellPos].bit == ONE) {
 
-      bool lastOneOnLine = true;
-      sf::Vector2i currPos = cellPos + EAST;
+    bool lastOneOnLine = !isThereOneEastOf(cellPos);
 
-      while (doesCellExists(currPos)) {
-        if (cells[currPos].bit == ONE)
-          lastOneOnLine = false;
-        currPos += EAST;
-      }
+    if (lastOneOnLine) {
 
-      if (lastOneOnLine) {
+      if (!doesCellExists(cellPos + EAST) ||
+          cells[cellPos + EAST].getStatus() == HALF_DEFINED) {
+        toRet.push_back(std::make_pair(cellPos + EAST, Cell(ZERO, ONE, true)));
 
-        if (!doesCellExists(cellPos + EAST) ||
-            cells[cellPos + EAST].getStatus() == HALF_DEFINED) {
-          toRet.push_back(
-              std::make_pair(cellPos + EAST, Cell(ZERO, ONE, true)));
+        if (inputType == CYCLE &&
+            doesCellExists(cellPos + EAST + cyclicForwardVector))
+          toRet.push_back(std::make_pair(cellPos + EAST + cyclicForwardVector,
+                                         Cell(ZERO, ONE, true)));
 
+        Vector2i newPos = cellPos + EAST + EAST;
+
+        while (doesCellExists(newPos)) {
+          toRet.push_back(std::make_pair(newPos, Cell(ZERO, ZERO)));
           if (inputType == CYCLE &&
-              doesCellExists(cellPos + EAST + cyclicForwardVector))
-            toRet.push_back(std::make_pair(cellPos + EAST + cyclicForwardVector,
-                                           Cell(ZERO, ONE, true)));
-
-          sf::Vector2i newPos = cellPos + EAST + EAST;
-
-          while (doesCellExists(newPos)) {
-            toRet.push_back(std::make_pair(newPos, Cell(ZERO, ZERO)));
-            if (inputType == CYCLE &&
-                doesCellExists(newPos + cyclicForwardVector))
-              toRet.push_back(std::make_pair(newPos + cyclicForwardVector,
-                                             Cell(ZERO, ZERO)));
-            newPos += EAST;
-          }
+              doesCellExists(newPos + cyclicForwardVector))
+            toRet.push_back(std::make_pair(newPos + cyclicForwardVector,
+                                           Cell(ZERO, ZERO)));
+          newPos += EAST;
+        }
 
-          if (inputType == CYCLE) {
-            while (doesCellExists(newPos + cyclicForwardVector)) {
-              toRet.push_back(std::make_pair(newPos + cyclicForwardVector,
-                                             Cell(ZERO, ZERO)));
-              newPos += EAST;
-            }
+        if (inputType == CYCLE) {
+          while (doesCellExists(newPos + cyclicForwardVector)) {
+            toRet.push_back(std::make_pair(newPos + cyclicForwardVector,
+                                           Cell(ZERO, ZERO)));
+            newPos += EAST;
           }
         }
       }
     }
   }
-
-  return toRet;
 }
 
 void World::nextNonLocal() {
-  auto nonLocalUpdates = findNonLocalUpdates();
-  applyUpdates(nonLocalUpdates);
+  applyUpdates(findNonLocalUpdates());
 
-  if (inputType == CYCLE) {
-    auto cyclicUpdates = findCyclicUpdates(nonLocalUpdates);
-    applyUpdates(cyclicUpdates);
-  }
+  if (inputType == CYCLE)
+    applyUpdates(findCyclicUpdates(nonLocalUpdates));
 }
 
-bool World::doesCellExists(const sf::Vector2i &cellPos) {
-  return cells.find(cellPos) != cells.end();
+bool World::doesCellExists(const Vector2i &cellPos) {
+  return cells.contains(cellPos);
 }
 
-std::vector<sf::Vector2i> World::getAndFlushGraphicBuffer() {
-  std::vector<sf::Vector2i> toRet = cellGraphicBuffer;
+void World::printStatistics() {
+  materialize();
+  printf("Number of cells: %ld\n", cells.size());
+  printf("Number of cells on edge: %ld\n", cellsOnEdge.size());
+  printf("Steps which grew the update buffers: %ld\n",
+         getNbBufferAllocations());
+  if (isStreaming())
+    printf("Evicted cells: %ld (%ld resident)\n", getNbEvictedCells(),
+           cells.size());
+  if (cells.getArena())
+    printf("Out-of-core tiles: %ld (%ld MB resident)\n",
+           cells.getArena()->getNbTiles(),
+           cells.getArena()->getResidentBytes() >> 20);
+  profile.print();
+}
+
+void World::getAndFlushGraphicBuffer(std::vector<Vector2i> &buffer) {
+  /**
+   * Hands the cells not drawn yet to `buffer` by swapping, its previous
+   * content is dropped but its memory is reused for the next cells.
+   */
+  materialize();
+  buffer.clear();
+  buffer.swap(cellGraphicBuffer);
+}
+
+void World::redraw() {
+  materialize();
   cellGraphicBuffer.clear();
-  return toRet;
+  if (!isGraphicBufferEnabled)
+    return;
+  cells.forEachTile([this](uint64_t key, const Tile &tile) {
+    Vector2i origin = CellStore::tileOrigin(key);
+    for (int iCell = 0; iCell < TILE_SIDE * TILE_SIDE; iCell += 1)
+      if (tile.get(iCell) != PACKED_ABSENT)
+        cellGraphicBuffer.push_back(
+            origin + Vector2i(iCell & TILE_MASK, iCell >> TILE_SHIFT));
+  });
+}
+
+void World::setGraphicBufferEnabled(bool isEnabled) {
+  /**
+   * Without a window, nothing flushes the graphic buffer: it is not filled
+   * so that it does not grow with the world.
+   */
+  isGraphicBufferEnabled = isEnabled;
+  if (!isEnabled)
+    cellGraphicBuffer.clear();
 }
 
 std::vector<int> World::base3To3p(std::string base3) {
@@ -292,6 +542,13 @@ std::vector<int> World::base3To3p(std::string base3) {
 }
 
 void World::setInputCells() {
+  /**
+   * The input cells go to the graphic buffer even when it is disabled: in
+   * sequential LINE/COL mode, they seed the worklist.
+   */
+  bool wasGraphicBufferEnabled = isGraphicBufferEnabled;
+  isGraphicBufferEnabled = true;
+
   switch (inputType) {
   case NONE:
     printf("Cannot input nothing to the world, you probably used a wrong "
@@ -321,13 +578,24 @@ void World::setInputCells() {
     exit(0);
     break;
   }
+
+  if (isSequentialSim)
+    seedWorklist();
+  setGraphicBufferEnabled(wasGraphicBufferEnabled);
 }
 
 void World::reset() {
   cells.clear();
   cellsOnEdge.clear();
+  edgeCandidates.clear();
+  isFullEdgeCleanNeeded = false;
+  rowSummaries.clear();
+  colSummaries.clear();
   cellGraphicBuffer.clear();
   parityVectorCells.clear();
+  nbTilesAfterEviction = 0;
+  nbSteps = 0;
+  profile.clear();
   setInputCells();
 }
 
@@ -345,4 +613,9 @@ void World::rotate(int direction) {
   assert(inputType == CYCLE || inputType == BORDER);
   inputStr = rotateStr(inputStr, direction);
   reset();
+}
+
+void World::setInput(const std::string &inputStr) {
+  this->inputStr = inputStr;
+  reset();
 }
\ No newline at end of file
@@ -2,114 +2,161 @@
 
 #include "config.h"
 
-#include <map>
+#include <climits>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "arguments.h"
+#include "big_int.h"
+#include "cell_store.h"
+#include "col_engine.h"
 #include "global.h"
+#include "macro_blocks.h"
+#include "parity_vector_solver.h"
+#include "row_engine.h"
+#include "step_profile.h"
+#include "thread_pool.h"
 
-static const sf::Vector2i ORIGIN_BORDER_MODE = sf::Vector2i(0, 0);
+static const Vector2i ORIGIN_BORDER_MODE = Vector2i(0, 0);
 
-enum AtomicInfo {
+// Below this edge size the updates are found by the calling thread only
+static const size_t MIN_EDGE_SIZE_PARALLEL_FIND = 1024;
+// Edge chunks per thread, several chunks per thread balance the load
+static const int NB_CHUNKS_PER_THREAD = 4;
+
+// LINE mode CA: below this number of steps, `advance` steps one by one
+static const int MIN_MACRO_BLOCK_STEPS = 16;
+// LINE mode CA: per chunk of steps, the macro blocks may compute these cells
+// per created cell, plus the cells needed to fill an empty memo
+static const uint64_t MAX_MACRO_BLOCK_CELLS_PER_NEW_CELL = 4;
+static const uint64_t MACRO_BLOCK_WARM_UP_CELLS = 1 << 14;
+
+// Cycle detection: polynomial hash of the cells of a cyclic cut
+static const uint64_t CUT_HASH_BASE = 0x9e3779b97f4a7c15ULL;
+
+// Streaming mode: rules read cells at most 1 cell away from the edge
+static const int MIN_STREAMING_MARGIN = 2;
+// Streaming mode: tiles created between two evictions, at least
+static const size_t MIN_NEW_TILES_BETWEEN_EVICTIONS = 64;
+
+typedef std::pair<Vector2i, Cell> CellPosAndCell;
+
+struct RowSummary {
   /***
-   * Bits and carrys can be either 0, 1 or undef (\bot in latex).
+   * Maintained summary of the cells of a row, it spares walking the row
+   * eastward when looking for ONE bits.
    */
-  UNDEF = -1,
-  ZERO = 0,
-  ONE = 1
-};
-
-enum CellStatus {
-  UNDEFINED = -1,   // bot bit and carry undefined
-  HALF_DEFINED = 1, // bit defined and carry undefined
-  DEFINED = 2       // bit-carry defined
+  int minX, maxX;   // Western and eastern extent of the row
+  int nbCells;      // Number of cells on the row
+  int rightmostOne; // x of the rightmost ONE bit, INT_MIN if none
+  RowSummary()
+      : minX(INT_MAX), maxX(INT_MIN), nbCells(0), rightmostOne(INT_MIN) {}
+  bool isContiguous() const { return nbCells == maxX - minX + 1; }
 };
 
-struct Cell {
+struct ColSummary {
   /***
-   * A cell contains a bit and a carry.
+   * Maintained summary of the cells of a column (COL mode), it spares
+   * walking the column northward when looking for non zero cells.
    */
-  AtomicInfo bit, carry;
-  bool isBootstrappingCarry;
-  Cell(AtomicInfo bit = UNDEF, AtomicInfo carry = UNDEF,
-       bool isBootstrappingCarry = false)
-      : bit(bit), carry(carry), isBootstrappingCarry(isBootstrappingCarry) {}
-  CellStatus getStatus() const {
-    if (bit == UNDEF && carry == UNDEF)
-      return UNDEFINED;
-    if (bit != UNDEF && carry == UNDEF)
-      return HALF_DEFINED;
-    if (bit != UNDEF && carry != UNDEF)
-      return DEFINED;
-    assert(false); // We should never meet the case where only the carry is
-                   // defined
-  }
-  int sum() const {
-    assert(getStatus() == DEFINED);
-    return static_cast<int>(bit) + static_cast<int>(carry);
-  }
-  int index() const {
-    /**
-     * Indexing in order {(0,0),(0,1),(1,0),(1,1)}.
-     */
-    assert(getStatus() == DEFINED);
-    return static_cast<int>(2 * bit) + static_cast<int>(carry);
-  }
+  int minY, maxY;     // Northern and southern extent of the column
+  int nbCells;        // Number of cells on the column
+  int topmostNonZero; // y of the topmost defined cell with non zero sum,
+                      // INT_MAX if none
+  ColSummary()
+      : minY(INT_MAX), maxY(INT_MIN), nbCells(0), topmostNonZero(INT_MAX) {}
+  bool isContiguous() const { return nbCells == maxY - minY + 1; }
 };
 
-typedef std::pair<sf::Vector2i, Cell> CellPosAndCell;
-
 class World {
   /***
-   * The world is a map of cells. A 2D Quasi CA rule dictates its evolution.
+   * The world is a tiled grid of cells. A 2D Quasi CA rule dictates its
+   * evolution.
    * It can also be simulated in a sequential manner.
    */
 public:
   World(bool isSequentialSim, InputType inputType, std::string inputStr,
-        bool constructCycleInLine, bool cycleBoth)
-      : isSequentialSim(isSequentialSim), inputType(inputType),
-        inputStr(inputStr), constructCycleInLine(constructCycleInLine),
-        cycleBoth(cycleBoth) {
-    if (isSequentialSim) {
-      printf("Sequential simulation not implemented yet. Abort.\n");
-      exit(0);
-    }
-
+        bool constructCycleInLine, bool cycleBoth, bool isFastEngineEnabled)
+      : inputStr(inputStr), inputType(inputType),
+        constructCycleInLine(constructCycleInLine), cycleBoth(cycleBoth),
+        isSequentialSim(isSequentialSim), nbSteps(0),
+        isFullEdgeCleanNeeded(false), nbBufferAllocations(0),
+        streamingMargin(-1), nbTilesAfterEviction(0), nbEvictedCells(0),
+        spillFile(NULL), isFastEngineEnabled(isFastEngineEnabled),
+        isGraphicBufferEnabled(true) {
     if (cycleBoth && constructCycleInLine)
       constructCycleInLine = false;
 
     setInputCells();
   }
+  ~World();
 
   static std::string base32(const std::string &base3) {
     /**
-     * Performs base 3 -> base 2 conversion.
+     * Performs base 3 -> base 2 conversion, in O(M(n) log n).
      */
-    unsigned long long int x = 0;
-    for (const auto &c : base3)
-      x = 3 * x + (c - '0');
-    std::string base2;
-    while (x) {
-      base2.push_back('0' + (x % 2));
-      x /= 2;
-    }
-    std::reverse(base2.begin(), base2.end());
-    return base2;
+    return BigInt::fromString(base3, 3).toBase2();
   }
 
-  void next();              // Next simulation step
-  bool isComputationDone(); // For border mode
-  bool isCycleDetected();   // For cycle mode
-  bool doesCellExists(const sf::Vector2i &cellPos);
+  void next();               // Next simulation step
+  void advance(int nbSteps); // `nbSteps` simulation steps at once
+  int getNbSteps() const { return nbSteps; } // Since the last reset
+  bool isComputationDone();  // For border mode
+  bool isCycleDetected();    // For cycle mode
+  bool doesCellExists(const Vector2i &cellPos);
   void reset();
   void rotate(int direction);
+  void setInput(const std::string &inputStr); // Same mode, from scratch
+  // Closed forms of cycle and border modes, see `parity_vector_solver.h`,
+  // checked against the cells the simulation has computed so far
   void printCycleInformation();
+  void printBorderInformation();
+  // Digits least significant first, until the first cell not yet defined
+  std::string readColumnOfSums();
+  std::string readRowOfBits();
+  std::pair<int, int> getDetectedCycle() const { return indexesDetectedCycle; }
+  // Row and col modes: prints the base 3' column and the base 2 row which
+  // encode the same number and returns the cell at their corner
+  Vector2i printBaseConversion(std::vector<Vector2i> &outlinedCells);
+  void printStatistics(); // What the `A` key prints about the world
+  size_t getNbBufferAllocations() const { return nbBufferAllocations; }
+  void setNbThreads(int nbThreads); // Threads used to find the updates
+  int getNbThreads() const {
+    return threadPool ? threadPool->getNbThreads() : 1;
+  }
+  bool isSequential() const { return isSequentialSim; }
+  // Per phase timing and counters of the steps since the last reset or
+  // since enabled, see `step_profile.h`. Printed by `printStatistics`
+  void setProfiling(bool isEnabled);
+  const StepProfile &getProfile() const { return profile; }
 
-  std::map<sf::Vector2i, Cell, compareWorldPositions>
-      cells;         // Contains only not undefined cells
+  // Streaming mode: fully defined tiles further than `margin` cells from the
+  // edge are evicted, callbacks are called on each evicted cell
+  typedef std::function<void(const Vector2i &, const Cell &)>
+      EvictionCallback;
+  void setStreaming(int margin);
+  void addEvictionCallback(const EvictionCallback &callback);
+  void spillEvictedCellsTo(const std::string &path); // Text, `x y bit carry`
+  bool isStreaming() const { return streamingMargin >= 0; }
+  size_t getNbEvictedCells() const { return nbEvictedCells; }
+
+  // Binary snapshots of the world, see `snapshot.cpp`
+  void saveSnapshot(const std::string &path);
+  void loadSnapshot(const std::string &path);
+  static void readSnapshotInput(const std::string &path, Arguments &arguments);
+
+  CellStore cells;   // Contains only not undefined cells
   Poset cellsOnEdge; // Buffer containing position of all cells on the edge of
                      // the computed world
-  std::vector<sf::Vector2i> getAndFlushGraphicBuffer();
+  void getAndFlushGraphicBuffer(
+      std::vector<Vector2i> &buffer); // Swapped, no copy
+  void redraw(); // Every cell goes back to the graphic buffer
+  void setGraphicBufferEnabled(bool isEnabled); // Off when nothing draws
+  void materialize(); // Fast engines: writes the computed cells to `cells`
   std::string inputStr; // FIXME: public only required for
                         // GraphicEngine::renderSelectedBorder()
   InputType inputType;
@@ -118,38 +165,112 @@ public:
                              // per col
   bool cycleBoth;
 
-  sf::Vector2i cyclicForwardVector;
-  std::vector<sf::Vector2i> parityVectorCells; // Border and cycle mode, all
-                                               // cells along parity vector
+  Vector2i cyclicForwardVector;
+  std::vector<Vector2i> parityVectorCells; // Border and cycle mode, all
+                                           // cells along parity vector
 
 private:
   bool isSequentialSim; // Run in sequential mode or CA-style mode?
+  int nbSteps;
+  StepProfile profile;
 
   // Simulation
-  std::vector<CellPosAndCell> findNonLocalUpdates();
+  const std::vector<CellPosAndCell> &findNonLocalUpdates();
   void nextNonLocal();
   void nextLocal();
-  std::vector<CellPosAndCell> findCarryPropUpdates();
-  std::vector<CellPosAndCell> findForwardDeductionUpdates();
-  std::vector<CellPosAndCell> findBackwardDeductionUpdates();
+  const std::vector<CellPosAndCell> &findCarryPropUpdates();
+  const std::vector<CellPosAndCell> &findForwardDeductionUpdates();
+  const std::vector<CellPosAndCell> &findBackwardDeductionUpdates();
+  // Rules applied to a single cell of the edge
+  void findNonLocalUpdate(const Vector2i &cellPos,
+                          std::vector<CellPosAndCell> &toRet);
+  void findCarryPropUpdate(const Vector2i &cellPos,
+                           std::vector<CellPosAndCell> &toRet);
+  void findForwardDeductionUpdate(const Vector2i &cellPos,
+                                  std::vector<CellPosAndCell> &toRet);
+  void findBackwardDeductionUpdate(const Vector2i &cellPos,
+                                   std::vector<CellPosAndCell> &toRet);
+  typedef void (World::*CellRule)(const Vector2i &cellPos,
+                                  std::vector<CellPosAndCell> &toRet);
+  void findEdgeUpdates(CellRule findUpdate,
+                       std::vector<CellPosAndCell> &toRet);
   void applyUpdates(const std::vector<CellPosAndCell> &updates);
   // Because we simulate an infinite process with finite means we have some edge
   // cases to deal with
   void manageEdgeCases(std::vector<CellPosAndCell> &toRet,
-                       const sf::Vector2i &cellPos, const Cell &updatedCell);
+                       const Vector2i &cellPos, const Cell &updatedCell);
 
-  bool isCellOnEdge(const sf::Vector2i &cellPos);
+  bool isCellOnEdge(const Vector2i &cellPos);
+  std::unordered_map<int, RowSummary> rowSummaries;
+  void updateRowSummary(const Vector2i &cellPos, bool wasPresent,
+                        AtomicInfo oldBit, AtomicInfo newBit);
+  bool isThereOneEastOf(const Vector2i &cellPos);
   void cleanCellsOnEdge();
+  std::vector<Vector2i> edgeCandidates; // Cells to re-examine at next
+                                        // cleaning
+  bool isFullEdgeCleanNeeded; // Set when the candidates are not enough
+
+  // Per phase buffers, cleared but not freed from one step to the next so
+  // that a step does not allocate once they have reached their size
+  std::vector<CellPosAndCell> nonLocalUpdates;
+  std::vector<CellPosAndCell> carryPropUpdates;
+  std::vector<CellPosAndCell> deductionUpdates; // Forward or backward
+  std::vector<CellPosAndCell> cyclicUpdates;
+  std::vector<Vector2i> edgeToRemove;
+  size_t nbBufferAllocations; // Steps during which a buffer had to grow
+  size_t getBuffersCapacity() const;
+
+  // Parallel find phases: the edge is split in chunks whose updates are
+  // concatenated in edge order, the result does not depend on the threads
+  std::unique_ptr<ThreadPool> threadPool; // NULL when single threaded
+  std::vector<std::vector<CellPosAndCell>> chunkUpdates;
+
+  // Sequential mode: a worklist of cells on which a rule may apply, a cell
+  // is enqueued again only when one of the cells its rules read changed
+  void seedWorklist();
+  void nextSequential();
+  bool isSequentialCandidate(const Vector2i &cellPos);
+  void processCell(const Vector2i &cellPos);
+  void applySequentialUpdates(const std::vector<CellPosAndCell> &updates);
+  void applyAndEnqueue(const std::vector<CellPosAndCell> &updates);
+  void enqueue(const Vector2i &cellPos);
+  std::deque<Vector2i> worklist;
+  FlatPosSet queuedCells; // Cells currently in `worklist`
+  std::vector<CellPosAndCell> sequentialUpdates;
+  std::vector<Vector2i> erasedOnes; // Cells whose ONE bit was overwritten
 
   // Input
   void setInputCells();
 
+  // Streaming mode
+  int streamingMargin; // -1 when not streaming
+  size_t nbTilesAfterEviction;
+  size_t nbEvictedCells;
+  std::vector<EvictionCallback> evictionCallbacks;
+  FILE *spillFile;
+  void evictFarCellsIfNeeded();
+  void evictFarCells();
+
+  // Fast engines, compute whole rows or columns at once
+  bool isFastEngineEnabled;
+  RowEngine rowEngine; // Line mode
+  ColEngine colEngine; // Col mode
+  int nbMaterializedRows;
+  int nbMaterializedCols;
+  void updateFastEngineEdge();
+
   // Line mode
   void setInputCellsLine();
+  MacroBlocks macroBlocks; // Memoized blocks of the CA, kept across resets
+  void advanceByMacroBlocks(int nbSteps);
 
   // Col mode
   std::vector<int> base3To3p(std::string base3);
   void setInputCellsCol();
+  std::unordered_map<int, ColSummary> colSummaries;
+  void updateColSummary(const Vector2i &cellPos, bool wasPresent,
+                        const Cell &oldCell, const Cell &newCell);
+  bool isOnlyZeroNorthOf(const Vector2i &cellPos);
 
   // Border mode
   void setInputCellsBorder();
@@ -158,15 +279,29 @@ private:
   void setInputCellsCycle();
   void computeParityVectorSpan();
   int parityVectorSpan;
-  std::vector<CellPosAndCell>
+  const std::vector<CellPosAndCell> &
   findCyclicUpdates(const std::vector<CellPosAndCell> &updates);
-  std::vector<sf::Vector2i> cellPosOnCyclicCut(int layerToCompute);
-  std::map<std::string, int> cycleDetectionMap;
-  std::string stringOfCyclicCut(const std::vector<sf::Vector2i> &cellPosOnCut);
+  // Cycle detection: one hash per layer, cuts are compared exactly on hash
+  // hits only. The defined cells of each cut are counted as they are
+  // applied, a cut is hashed once, when it is complete
+  Vector2i cyclicCutStart(int iLayer);
+  void initCyclicCuts();
+  void updateCyclicCutCounters(const Vector2i &cellPos, int delta);
+  bool isCyclicCutDefined(int iLayer);
+  uint64_t hashOfCyclicCut(int iLayer);
+  bool areCyclicCutsEqual(int iLayer, int jLayer);
+  void restoreCycleDetection(int nbLayers);
+  std::vector<int> nbOnesBeforeCutCell; // Per cell of the cut
+  std::vector<int> firstCutCellOfRow;   // Constructing per row
+  std::vector<int> nbDefinedCutCells;   // Per layer
+  std::unordered_multimap<uint64_t, int> cycleDetectionHashes; // To layers
+  int cutLayer; // Next layer to compare
   // For rendering
-  std::vector<sf::Vector2i> cellGraphicBuffer; // Cells that are not drawn yet
-  std::pair<int, int> indexesDetectedCycle;    // Contains the information about
-                                               // the detected cycle
+  std::vector<Vector2i> cellGraphicBuffer; // Cells that are not drawn yet
+  std::pair<int, int> indexesDetectedCycle; // Contains the information about
+                                            // the detected cycle
+  // Headless worlds have no window to drain the graphic buffer
+  bool isGraphicBufferEnabled;
   std::vector<CellPosAndCell>
   findTweakSouthBorderUpdates(); // FIXME: do this more cleanly
   bool alreadyTweaked;
@@ -0,0 +1,357 @@
+/**
+ * Arbitrary precision integers for base conversions, see `big_int.h`.
+ */
+
+#include "../big_int.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+static void mulSchoolbook(const uint32_t *a, size_t nbA, const uint32_t *b,
+                          size_t nbB, uint32_t *out) {
+  /**
+   * out[0 .. nbA + nbB) = a * b.
+   */
+  std::fill(out, out + nbA + nbB, 0);
+  for (size_t i = 0; i < nbA; i += 1) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < nbB; j += 1) {
+      uint64_t value = static_cast<uint64_t>(a[i]) * b[j] + out[i + j] + carry;
+      out[i + j] = static_cast<uint32_t>(value);
+      carry = value >> 32;
+    }
+    out[i + nbB] = static_cast<uint32_t>(carry);
+  }
+}
+
+static uint32_t addInPlace(uint32_t *acc, size_t nbAcc, const uint32_t *b,
+                           size_t nbB) {
+  /**
+   * acc += b with nbB <= nbAcc, returns the carry out of acc.
+   */
+  uint64_t carry = 0;
+  for (size_t i = 0; i < nbAcc && (i < nbB || carry); i += 1) {
+    uint64_t value = static_cast<uint64_t>(acc[i]) + carry;
+    if (i < nbB)
+      value += b[i];
+    acc[i] = static_cast<uint32_t>(value);
+    carry = value >> 32;
+  }
+  return static_cast<uint32_t>(carry);
+}
+
+static void subInPlace(uint32_t *acc, size_t nbAcc, const uint32_t *b,
+                       size_t nbB) {
+  /**
+   * acc -= b, the result must be non negative.
+   */
+  int64_t borrow = 0;
+  for (size_t i = 0; i < nbAcc && (i < nbB || borrow); i += 1) {
+    int64_t value = static_cast<int64_t>(acc[i]) - borrow;
+    if (i < nbB)
+      value -= b[i];
+    borrow = value < 0;
+    acc[i] = static_cast<uint32_t>(value + (borrow << 32));
+  }
+}
+
+static void mulKaratsuba(const uint32_t *a, const uint32_t *b, size_t n,
+                         uint32_t *out) {
+  /**
+   * out[0 .. 2n) = a * b where a and b have n limbs. With a = a1 B + a0 and
+   * b = b1 B + b0, a * b = z2 B^2 + z1 B + z0 where z1 is computed from
+   * (a0 + a1)(b0 + b1) - z0 - z2: 3 products of half size instead of 4.
+   */
+  if (n <= KARATSUBA_THRESHOLD) {
+    mulSchoolbook(a, n, b, n, out);
+    return;
+  }
+  size_t nbLow = n / 2, nbHigh = n - nbLow;
+  mulKaratsuba(a, b, nbLow, out);                              // z0
+  mulKaratsuba(a + nbLow, b + nbLow, nbHigh, out + 2 * nbLow); // z2
+
+  std::vector<uint32_t> sumA(a + nbLow, a + n), sumB(b + nbLow, b + n);
+  sumA.push_back(addInPlace(sumA.data(), nbHigh, a, nbLow));
+  sumB.push_back(addInPlace(sumB.data(), nbHigh, b, nbLow));
+  std::vector<uint32_t> z1(2 * (nbHigh + 1));
+  mulKaratsuba(sumA.data(), sumB.data(), nbHigh + 1, z1.data());
+  subInPlace(z1.data(), z1.size(), out, 2 * nbLow);
+  subInPlace(z1.data(), z1.size(), out + 2 * nbLow, 2 * nbHigh);
+
+  // z1 < 2^(32 * (n + 1)): its top limbs are 0 past the end of `out`
+  size_t nbZ1 = z1.size();
+  while (nbZ1 > 0 && z1[nbZ1 - 1] == 0)
+    nbZ1 -= 1;
+  addInPlace(out + nbLow, 2 * n - nbLow, z1.data(), nbZ1);
+}
+
+BigInt::BigInt(uint32_t value) {
+  if (value != 0)
+    limbs.push_back(value);
+}
+
+void BigInt::trim() {
+  while (!limbs.empty() && limbs.back() == 0)
+    limbs.pop_back();
+}
+
+BigInt BigInt::operator+(const BigInt &other) const {
+  const BigInt &longest = limbs.size() >= other.limbs.size() ? *this : other;
+  const BigInt &shortest = limbs.size() >= other.limbs.size() ? other : *this;
+  BigInt toRet = longest;
+  uint32_t carry =
+      addInPlace(toRet.limbs.data(), toRet.limbs.size(),
+                 shortest.limbs.data(), shortest.limbs.size());
+  if (carry)
+    toRet.limbs.push_back(carry);
+  return toRet;
+}
+
+BigInt BigInt::operator-(const BigInt &other) const {
+  assert(!(*this < other));
+  BigInt toRet = *this;
+  subInPlace(toRet.limbs.data(), toRet.limbs.size(), other.limbs.data(),
+             other.limbs.size());
+  toRet.trim();
+  return toRet;
+}
+
+bool BigInt::operator<(const BigInt &other) const {
+  if (limbs.size() != other.limbs.size())
+    return limbs.size() < other.limbs.size();
+  for (size_t iLimb = limbs.size(); iLimb > 0; iLimb -= 1)
+    if (limbs[iLimb - 1] != other.limbs[iLimb - 1])
+      return limbs[iLimb - 1] < other.limbs[iLimb - 1];
+  return false;
+}
+
+BigInt BigInt::operator<<(size_t nbBits) const {
+  BigInt toRet;
+  if (limbs.empty())
+    return toRet;
+  size_t nbLimbs = nbBits / 32, shift = nbBits % 32;
+  toRet.limbs.assign(nbLimbs, 0);
+  uint32_t carry = 0;
+  for (uint32_t limb : limbs) {
+    toRet.limbs.push_back((limb << shift) | carry);
+    carry = shift ? limb >> (32 - shift) : 0;
+  }
+  if (carry)
+    toRet.limbs.push_back(carry);
+  return toRet;
+}
+
+BigInt BigInt::operator>>(size_t nbBits) const {
+  BigInt toRet;
+  size_t nbLimbs = nbBits / 32, shift = nbBits % 32;
+  for (size_t iLimb = nbLimbs; iLimb < limbs.size(); iLimb += 1) {
+    uint32_t next = iLimb + 1 < limbs.size() ? limbs[iLimb + 1] : 0;
+    toRet.limbs.push_back(shift ? (limbs[iLimb] >> shift) |
+                                      (next << (32 - shift))
+                                : limbs[iLimb]);
+  }
+  toRet.trim();
+  return toRet;
+}
+
+BigInt BigInt::lowBits(size_t nbBits) const {
+  BigInt toRet;
+  size_t nbLimbs = (nbBits + 31) / 32;
+  toRet.limbs.assign(limbs.begin(),
+                     limbs.begin() + std::min(nbLimbs, limbs.size()));
+  if (nbBits % 32 != 0 && toRet.limbs.size() == nbLimbs)
+    toRet.limbs.back() &= (1u << (nbBits % 32)) - 1;
+  toRet.trim();
+  return toRet;
+}
+
+uint32_t BigInt::divideBy(uint32_t divisor) {
+  uint64_t remainder = 0;
+  for (size_t iLimb = limbs.size(); iLimb > 0; iLimb -= 1) {
+    uint64_t value = (remainder << 32) | limbs[iLimb - 1];
+    limbs[iLimb - 1] = static_cast<uint32_t>(value / divisor);
+    remainder = value % divisor;
+  }
+  trim();
+  return static_cast<uint32_t>(remainder);
+}
+
+void BigInt::divideExactlyBy(uint32_t divisor) {
+  /**
+   * Least significant limb first with the inverse of the divisor modulo
+   * 2^32, no hardware division.
+   */
+  assert(divisor & 1);
+  uint32_t inverse = divisor; // Newton iteration, correct on 3, 6, 12 ... bits
+  for (int iStep = 0; iStep < 4; iStep += 1)
+    inverse *= 2 - divisor * inverse;
+  uint32_t borrow = 0;
+  for (uint32_t &limb : limbs) {
+    uint32_t nextBorrow = limb < borrow;
+    uint32_t quotient = (limb - borrow) * inverse;
+    limb = quotient;
+    borrow = static_cast<uint32_t>(
+                 (static_cast<uint64_t>(quotient) * divisor) >> 32) +
+             nextBorrow;
+  }
+  assert(borrow == 0);
+  trim();
+}
+
+uint32_t BigInt::modulo3() const {
+  // 2^32 = 1 modulo 3
+  uint64_t sum = 0;
+  for (uint32_t limb : limbs)
+    sum += limb;
+  return static_cast<uint32_t>(sum % 3);
+}
+
+BigInt BigInt::power(uint32_t base, size_t exponent) {
+  /**
+   * Square and multiply, most significant bit of the exponent first.
+   */
+  BigInt toRet(1);
+  for (size_t iBit = 8 * sizeof(size_t); iBit > 0; iBit -= 1) {
+    toRet = toRet * toRet;
+    if ((exponent >> (iBit - 1)) & 1)
+      toRet = toRet * BigInt(base);
+  }
+  return toRet;
+}
+
+BigInt BigInt::operator*(const BigInt &other) const {
+  /**
+   * Unbalanced products are cut in balanced Karatsuba products: the longest
+   * factor is split in pieces as long as the shortest one.
+   */
+  const std::vector<uint32_t> &longest =
+      limbs.size() >= other.limbs.size() ? limbs : other.limbs;
+  const std::vector<uint32_t> &shortest =
+      limbs.size() >= other.limbs.size() ? other.limbs : limbs;
+  BigInt toRet;
+  if (shortest.empty())
+    return toRet;
+  size_t nbLongest = longest.size(), nbShortest = shortest.size();
+  toRet.limbs.assign(nbLongest + nbShortest, 0);
+  if (nbShortest <= KARATSUBA_THRESHOLD) {
+    mulSchoolbook(longest.data(), nbLongest, shortest.data(), nbShortest,
+                  toRet.limbs.data());
+    toRet.trim();
+    return toRet;
+  }
+
+  std::vector<uint32_t> piece(nbShortest), product(2 * nbShortest);
+  for (size_t iStart = 0; iStart < nbLongest; iStart += nbShortest) {
+    size_t nbPiece = std::min(nbShortest, nbLongest - iStart);
+    std::fill(piece.begin(), piece.end(), 0);
+    std::copy(longest.begin() + iStart, longest.begin() + iStart + nbPiece,
+              piece.begin());
+    mulKaratsuba(piece.data(), shortest.data(), nbShortest, product.data());
+    size_t nbProduct = nbPiece + nbShortest;
+    addInPlace(toRet.limbs.data() + iStart, toRet.limbs.size() - iStart,
+               product.data(), nbProduct);
+  }
+  toRet.trim();
+  return toRet;
+}
+
+BigInt BigInt::fromDigitsRange(const uint32_t *digits, size_t nbDigits,
+                               uint32_t base, std::vector<BigInt> &powers) {
+  /**
+   * The least significant part is DIGITS_PER_LEAF * 2^k digits long so that
+   * the powers of the base it is shifted by are shared, and computed once,
+   * by squaring.
+   */
+  if (nbDigits <= DIGITS_PER_LEAF) {
+    BigInt toRet;
+    for (size_t iDigit = 0; iDigit < nbDigits; iDigit += 1) {
+      uint64_t carry = digits[iDigit];
+      for (uint32_t &limb : toRet.limbs) {
+        uint64_t value = static_cast<uint64_t>(limb) * base + carry;
+        limb = static_cast<uint32_t>(value);
+        carry = value >> 32;
+      }
+      if (carry)
+        toRet.limbs.push_back(static_cast<uint32_t>(carry));
+    }
+    return toRet;
+  }
+
+  size_t iPower = 0, nbLowDigits = DIGITS_PER_LEAF;
+  while (2 * nbLowDigits < nbDigits) {
+    nbLowDigits *= 2;
+    iPower += 1;
+  }
+  if (powers.empty()) {
+    BigInt leafPower(1);
+    for (int iDigit = 0; iDigit < DIGITS_PER_LEAF; iDigit += 1)
+      leafPower = leafPower * BigInt(base);
+    powers.push_back(leafPower);
+  }
+  while (powers.size() <= iPower)
+    powers.push_back(powers.back() * powers.back());
+
+  size_t nbHighDigits = nbDigits - nbLowDigits;
+  BigInt high = fromDigitsRange(digits, nbHighDigits, base, powers);
+  BigInt low =
+      fromDigitsRange(digits + nbHighDigits, nbLowDigits, base, powers);
+  return high * powers[iPower] + low;
+}
+
+BigInt BigInt::fromDigits(const std::vector<uint32_t> &digits,
+                          uint32_t base) {
+  std::vector<BigInt> powers; // base^(DIGITS_PER_LEAF * 2^k)
+  return fromDigitsRange(digits.data(), digits.size(), base, powers);
+}
+
+BigInt BigInt::fromString(const std::string &digits, uint32_t base) {
+  std::vector<uint32_t> values;
+  values.reserve(digits.size());
+  for (char c : digits)
+    values.push_back(c - '0');
+  return fromDigits(values, base);
+}
+
+size_t BigInt::getNbBits() const {
+  if (limbs.empty())
+    return 0;
+  size_t nbBits = 32 * (limbs.size() - 1);
+  for (uint32_t top = limbs.back(); top != 0; top >>= 1)
+    nbBits += 1;
+  return nbBits;
+}
+
+std::string BigInt::toBase2() const {
+  std::string toRet;
+  toRet.reserve(getNbBits());
+  for (size_t iBit = getNbBits(); iBit > 0; iBit -= 1)
+    toRet.push_back('0' + ((limbs[(iBit - 1) / 32] >> ((iBit - 1) % 32)) & 1));
+  return toRet;
+}
+
+std::string BigInt::toDecimal() const {
+  /**
+   * Repeated divisions by 10^9.
+   */
+  if (limbs.empty())
+    return "0";
+  BigInt quotient = *this;
+  std::vector<uint32_t> chunks; // 9 decimal digits each, least significant
+                                // first
+  while (!quotient.isZero())
+    chunks.push_back(quotient.divideBy(1000000000));
+  std::string toRet = std::to_string(chunks.back());
+  char chunk[10];
+  for (size_t iChunk = chunks.size() - 1; iChunk > 0; iChunk -= 1) {
+    snprintf(chunk, sizeof(chunk), "%09u", chunks[iChunk - 1]);
+    toRet += chunk;
+  }
+  return toRet;
+}
+
+std::string BigInt::toReadout() const {
+  if (getNbBits() > MAX_DECIMAL_READOUT_BITS)
+    return "a " + std::to_string(getNbBits()) + " bits number";
+  return toDecimal();
+}
@@ -5,6 +5,8 @@
 
 #include "../world.h"
 
+#include <algorithm>
+
 void World::setInputCellsBorder() {
   /**
    * Set up the initial configuration in Border mode.
@@ -13,7 +15,7 @@ void World::setInputCellsBorder() {
   alreadyTweaked = false;
 
   std::vector<CellPosAndCell> updates;
-  sf::Vector2i currPos = ORIGIN_BORDER_MODE;
+  Vector2i currPos = ORIGIN_BORDER_MODE;
   for (char parityBit : inputStr) {
     if (parityBit != '0' && parityBit != '1') {
       printf(
@@ -42,7 +44,7 @@ bool World::isComputationDone() {
    * In border mode, the computation space is finite.
    */
   assert(inputType == BORDER);
-  sf::Vector2i topLeftCellPos = {-1 * static_cast<int>(inputStr.length()) + 1,
+  Vector2i topLeftCellPos = {-1 * static_cast<int>(inputStr.length()) + 1,
                                  0};
   return doesCellExists(topLeftCellPos) &&
          cells[topLeftCellPos].getStatus() == DEFINED;
@@ -62,11 +64,13 @@ void World::setInputCellsCycle() {
    * Set up the initial configuration in Cycle mode.
    */
   assert(inputType == CYCLE);
+  computeParityVectorSpan();
+  initCyclicCuts();
   setInputCellsBorder();
 
-  cycleDetectionMap.clear();
+  cycleDetectionHashes.clear();
+  cutLayer = 0;
   indexesDetectedCycle = std::make_pair(-1, -1);
-  computeParityVectorSpan();
   cyclicForwardVector = ORIGIN_BORDER_MODE;
   for (int iWest = 0; iWest < inputStr.length(); iWest += 1)
     cyclicForwardVector += WEST;
@@ -77,21 +81,23 @@ void World::setInputCellsCycle() {
       {std::make_pair(cyclicForwardVector, cells[ORIGIN_BORDER_MODE])});
 }
 
-std::vector<CellPosAndCell>
+const std::vector<CellPosAndCell> &
 World::findCyclicUpdates(const std::vector<CellPosAndCell> &updates) {
   /**
    * Find cells on which we can apply the cyclic equivalence relation.
    */
+  PROFILE_PHASE(PHASE_CYCLIC);
 
-  std::vector<CellPosAndCell> toRet;
+  std::vector<CellPosAndCell> &toRet = cyclicUpdates;
+  toRet.clear();
 
   for (const auto &update : updates) {
-    const sf::Vector2i &pos = update.first;
+    const Vector2i &pos = update.first;
     const Cell &cell = update.second;
 
     if (!constructCycleInLine || cycleBoth) {
       if ((pos - cyclicForwardVector).x == ORIGIN_BORDER_MODE.x) {
-        sf::Vector2i posEquivalent = pos - cyclicForwardVector;
+        Vector2i posEquivalent = pos - cyclicForwardVector;
         toRet.push_back(std::make_pair(posEquivalent, cell));
       }
     }
@@ -99,49 +105,109 @@ World::findCyclicUpdates(const std::vector<CellPosAndCell> &updates) {
     if (constructCycleInLine || cycleBoth) {
       if ((pos + cyclicForwardVector).y ==
           ORIGIN_BORDER_MODE.y + parityVectorSpan) {
-        sf::Vector2i posEquivalent = pos + cyclicForwardVector;
+        Vector2i posEquivalent = pos + cyclicForwardVector;
         toRet.push_back(std::make_pair(posEquivalent, cell));
       }
     }
   }
+  PROFILE_UPDATES(PHASE_CYCLIC, toRet.size());
   return toRet;
 }
 
-std::vector<sf::Vector2i> World::cellPosOnCyclicCut(int layerToCompute) {
+Vector2i World::cyclicCutStart(int iLayer) {
   /**
-   * Returns the cells sitting the translation of the parity vector
-   * starting at (0,yStart).
+   * The cyclic cut of a layer is the translation of the parity vector
+   * starting at (0,-iLayer), or (-iLayer,0) when constructing per row.
    */
-  assert(inputType == CYCLE);
-  std::vector<sf::Vector2i> toRet;
-  sf::Vector2i currentPos;
   if (!constructCycleInLine)
-    currentPos = {ORIGIN_BORDER_MODE.x, ORIGIN_BORDER_MODE.y - layerToCompute};
-  else
-    currentPos = {ORIGIN_BORDER_MODE.x - layerToCompute, ORIGIN_BORDER_MODE.y};
+    return {ORIGIN_BORDER_MODE.x, ORIGIN_BORDER_MODE.y - iLayer};
+  return {ORIGIN_BORDER_MODE.x - iLayer, ORIGIN_BORDER_MODE.y};
+}
+
+void World::initCyclicCuts() {
+  /**
+   * Cell k of a cut sits nbOnesBefore[k] rows south of the start of the cut.
+   * Constructing per row, the cells of a cut on row y are the ones from
+   * firstCutCellOfRow[y] to firstCutCellOfRow[y + 1] excluded.
+   */
+  int nbCutCells = static_cast<int>(inputStr.size());
+  nbOnesBeforeCutCell.assign(1, 0);
+  firstCutCellOfRow.assign(1, 0);
+  for (int k = 0; k < nbCutCells; k += 1) {
+    nbOnesBeforeCutCell.push_back(nbOnesBeforeCutCell.back() +
+                                  (inputStr[k] == '1'));
+    if (inputStr[k] == '1')
+      firstCutCellOfRow.push_back(k + 1);
+  }
+  firstCutCellOfRow.push_back(nbCutCells);
+  nbDefinedCutCells.clear();
+}
+
+void World::updateCyclicCutCounters(const Vector2i &cellPos, int delta) {
+  /**
+   * Adds `delta` to the counters of the layers whose cut goes through
+   * `cellPos`. Constructing per column a cell is on at most one cut, per row
+   * on as many cuts as there are `0`s in a row of the parity vector.
+   */
+  int nbCutCells = static_cast<int>(inputStr.size());
+  auto count = [&](int iLayer) {
+    if (iLayer < 0)
+      return;
+    if (iLayer >= static_cast<int>(nbDefinedCutCells.size()))
+      nbDefinedCutCells.resize(iLayer + 1, 0);
+    nbDefinedCutCells[iLayer] += delta;
+  };
+  Vector2i fromOrigin = cellPos - ORIGIN_BORDER_MODE;
+  if (!constructCycleInLine) {
+    int k = -fromOrigin.x;
+    if (k >= 0 && k < nbCutCells)
+      count(nbOnesBeforeCutCell[k] - fromOrigin.y);
+  } else {
+    int y = fromOrigin.y;
+    if (y < 0 || y + 1 >= static_cast<int>(firstCutCellOfRow.size()))
+      return;
+    for (int k = firstCutCellOfRow[y]; k < firstCutCellOfRow[y + 1]; k += 1)
+      count(-fromOrigin.x - k);
+  }
+}
+
+bool World::isCyclicCutDefined(int iLayer) {
+  return iLayer < static_cast<int>(nbDefinedCutCells.size()) &&
+         nbDefinedCutCells[iLayer] == static_cast<int>(inputStr.size());
+}
+
+uint64_t World::hashOfCyclicCut(int iLayer) {
+  /**
+   * Polynomial hash of the cells of a fully defined cut.
+   */
+  uint64_t hash = 0;
+  Vector2i cellPos = cyclicCutStart(iLayer);
   for (auto c : inputStr) {
-    toRet.push_back(currentPos);
+    hash = hash * CUT_HASH_BASE + cells[cellPos].index() + 1;
     if (c == '1')
-      currentPos += SOUTH;
-    currentPos += WEST;
+      cellPos += SOUTH;
+    cellPos += WEST;
   }
-  return toRet;
+  return hash;
 }
 
-std::string
-World::stringOfCyclicCut(const std::vector<sf::Vector2i> &cellPosOnCut) {
+bool World::areCyclicCutsEqual(int iLayer, int jLayer) {
   /**
-   * Transforms a cyclic cut into the string of its trit or "" if not all
-   * defined.
+   * Exact comparison of two fully defined cuts, on hash hits only.
    */
-  assert(inputType == CYCLE);
-  std::string toRet = "";
-  for (const auto &pos : cellPosOnCut) {
-    if (!doesCellExists(pos) || cells[pos].getStatus() != DEFINED)
-      return "";
-    toRet += '0' + cells[pos].index();
+  Vector2i iPos = cyclicCutStart(iLayer);
+  Vector2i jPos = cyclicCutStart(jLayer);
+  for (auto c : inputStr) {
+    if (cells[iPos].index() != cells[jPos].index())
+      return false;
+    if (c == '1') {
+      iPos += SOUTH;
+      jPos += SOUTH;
+    }
+    iPos += WEST;
+    jPos += WEST;
   }
-  return toRet;
+  return true;
 }
 
 bool World::isCycleDetected() {
@@ -149,73 +215,84 @@ bool World::isCycleDetected() {
   if (indexesDetectedCycle.first != -1)
     return true;
 
-  int layerToCompute = cycleDetectionMap.size();
-  std::string stringOfLayer =
-      stringOfCyclicCut(cellPosOnCyclicCut(layerToCompute));
-
   // Current layer not finishing computing yet
-  if (stringOfLayer.size() == 0)
+  if (!isCyclicCutDefined(cutLayer))
     return false;
 
-  if (cycleDetectionMap.find(stringOfLayer) != cycleDetectionMap.end()) {
-    indexesDetectedCycle =
-        std::make_pair(cycleDetectionMap[stringOfLayer], layerToCompute);
-    return true;
-  }
+  uint64_t hash = hashOfCyclicCut(cutLayer);
+  auto candidates = cycleDetectionHashes.equal_range(hash);
+  for (auto it = candidates.first; it != candidates.second; ++it)
+    if (areCyclicCutsEqual(it->second, cutLayer)) {
+      indexesDetectedCycle = std::make_pair(it->second, cutLayer);
+      return true;
+    }
 
-  cycleDetectionMap[stringOfLayer] = layerToCompute;
+  cycleDetectionHashes.insert(std::make_pair(hash, cutLayer));
+  cutLayer += 1;
   return false;
 }
 
-void World::printCycleInformation() {
+void World::restoreCycleDetection(int nbLayers) {
   /**
-   * Prints the 3-adic/2-adic representation of the cycle the supported by the
-   * input parity vector.
+   * Counts the defined cells of each cut and hashes again the cuts of the
+   * layers already compared, after the cells were restored.
    */
-  assert(inputType == CYCLE && indexesDetectedCycle.first != -1);
-  printf(
-      "The cycle supported by the parity vector %s has the following rational ",
-      inputStr.c_str());
-  if (!constructCycleInLine)
-    printf("3-adic ");
-  else
-    printf("2-adic ");
-  printf("expansion:\n");
-
-  std::string initSeg = "";
-  std::string period = "";
-  int parityVectorNorm = static_cast<int>(inputStr.size());
-  int which = static_cast<int>(cells[ORIGIN_BORDER_MODE].bit);
-  if (!constructCycleInLine) {
-    for (int y = ORIGIN_BORDER_MODE.y + parityVectorSpan - 1;
-         y >= -1 * indexesDetectedCycle.first + parityVectorSpan - 1; y -= 1) {
-      sf::Vector2i cellPos = {ORIGIN_BORDER_MODE.x - parityVectorNorm + 1, y};
-      assert(doesCellExists(cellPos) && cells[cellPos].getStatus() == DEFINED);
-      initSeg += cells[cellPos].sum() + '0';
-    }
-    for (int y = -1 * indexesDetectedCycle.first - 1 + parityVectorSpan - 1;
-         y >= -1 * indexesDetectedCycle.second + parityVectorSpan - 1; y -= 1) {
-      sf::Vector2i cellPos = {ORIGIN_BORDER_MODE.x - parityVectorNorm + 1, y};
-      assert(doesCellExists(cellPos) && cells[cellPos].getStatus() == DEFINED);
-      period += cells[cellPos].sum() + '0';
-    }
-  } else {
-    for (int x = ORIGIN_BORDER_MODE.x; x >= -1 * indexesDetectedCycle.first;
-         x -= 1) {
-      sf::Vector2i cellPos = {x, ORIGIN_BORDER_MODE.y};
-      if (!doesCellExists(cellPos))
-        continue;
-      // assert(doesCellExists(cellPos) && cells[cellPos].getStatus() ==
-      // DEFINED);
-      initSeg += static_cast<int>(cells[cellPos].bit) + '0';
-    }
-    for (int x = -1 * indexesDetectedCycle.first - 1;
-         x >= -1 * indexesDetectedCycle.second; x -= 1) {
-      sf::Vector2i cellPos = {x, ORIGIN_BORDER_MODE.y};
-      assert(doesCellExists(cellPos) && cells[cellPos].getStatus() == DEFINED);
-      period += static_cast<int>(cells[cellPos].bit) + '0';
-    }
+  assert(inputType == CYCLE);
+  nbDefinedCutCells.clear();
+  cells.forEachTile([this](uint64_t key, const Tile &tile) {
+    Vector2i origin = CellStore::tileOrigin(key);
+    for (int iCell = 0; iCell < TILE_SIDE * TILE_SIDE; iCell += 1)
+      if (unpackCell(tile.get(iCell)).getStatus() == DEFINED)
+        updateCyclicCutCounters(
+            origin + Vector2i(iCell & TILE_MASK, iCell >> TILE_SHIFT), 1);
+  });
+
+  cycleDetectionHashes.clear();
+  for (int iLayer = 0; iLayer < nbLayers; iLayer += 1) {
+    assert(isCyclicCutDefined(iLayer));
+    cycleDetectionHashes.insert(
+        std::make_pair(hashOfCyclicCut(iLayer), iLayer));
   }
+  cutLayer = nbLayers;
+}
+
+std::string World::readColumnOfSums() {
+  /**
+   * The column of the last parity bit, from the row of the last `1` to the
+   * north: base 3 digits in cycle mode, the output number in border mode.
+   */
+  int span =
+      static_cast<int>(std::count(inputStr.begin(), inputStr.end(), '1'));
+  std::string digits;
+  Vector2i cellPos = {
+      ORIGIN_BORDER_MODE.x - static_cast<int>(inputStr.size()) + 1,
+      ORIGIN_BORDER_MODE.y + span - 1};
+  for (; doesCellExists(cellPos) && cells[cellPos].getStatus() == DEFINED;
+       cellPos += NORTH)
+    digits += cells[cellPos].sum() + '0';
+  return digits;
+}
+
+std::string World::readRowOfBits() {
+  /**
+   * The row of the first parity bit, to the west: base 2 digits in cycle
+   * mode, the input number in border mode.
+   */
+  std::string digits;
+  for (Vector2i cellPos = ORIGIN_BORDER_MODE;
+       doesCellExists(cellPos) && cells[cellPos].getStatus() == DEFINED;
+       cellPos += WEST)
+    digits += static_cast<int>(cells[cellPos].bit) + '0';
+  return digits;
+}
+
+static void printExpansion(const PAdicExpansion &expansion) {
+  std::string initSeg = expansion.initialSegment;
+  std::string period = expansion.period;
+  if (!expansion.isPeriodComplete)
+    printf("The period is longer than %d digits, only its beginning is "
+           "printed.\n",
+           MAX_EXPANSION_PERIOD);
 
   printf("\nBig endian convention\n");
   printf("=====================\n");
@@ -234,9 +311,85 @@ void World::printCycleInformation() {
   printf("Initial segment: %s\n", initSeg.c_str());
   printf("Period: %s\n", period.c_str());
   printf("Number: (%s)^inf %s\n\n", period.c_str(), initSeg.c_str());
-  printf("\nNote that: due to the way it is detected, the initial segment can "
-         "contain part of the period and that the period is not necessarily "
-         "minimal.\n");
+}
+
+static void checkExpansion(const std::string &digits,
+                           const PAdicExpansion &expansion, int base) {
+  if (digits.empty())
+    return;
+  for (size_t iDigit = 0; iDigit < digits.size(); iDigit += 1)
+    if (digits[iDigit] != expansion.digitAt(iDigit)) {
+      printf("Mismatch: digit %zu of the %d-adic expansion is %c in the "
+             "simulation.\n",
+             iDigit, base, digits[iDigit]);
+      return;
+    }
+  printf("The %zu %d-adic digits computed by the simulation agree with this "
+         "expansion.\n",
+         digits.size(), base);
+}
+
+void World::printCycleInformation() {
+  /**
+   * Prints the rational cycle supported by the input parity vector and its
+   * 3-adic/2-adic expansion, computed from the vector only: the simulation
+   * does not need to have detected the cycle. The digits it has computed so
+   * far are checked against the expansion.
+   */
+  assert(inputType == CYCLE);
+  ParityVectorSolver solver(inputStr);
+  bool isNegative =
+      solver.isCycleNegative() && !solver.getCycleNumerator().isZero();
+  printf("The cycle supported by the parity vector %s is the rational "
+         "%s%s / %s, where %s = |2^%zu - 3^%d|.\n",
+         inputStr.c_str(), isNegative ? "-" : "",
+         solver.getCycleNumerator().toReadout().c_str(),
+         solver.getCycleDenominator().toReadout().c_str(),
+         solver.getCycleDenominator().toReadout().c_str(), inputStr.size(),
+         parityVectorSpan);
+
+  if (!constructCycleInLine || cycleBoth) {
+    PAdicExpansion expansion = solver.expandCycle(3);
+    printf("It has the following rational 3-adic expansion:\n");
+    printExpansion(expansion);
+    checkExpansion(readColumnOfSums(), expansion, 3);
+  }
+  if (constructCycleInLine || cycleBoth) {
+    PAdicExpansion expansion = solver.expandCycle(2);
+    printf("It has the following rational 2-adic expansion:\n");
+    printExpansion(expansion);
+    checkExpansion(readRowOfBits(), expansion, 2);
+  }
+}
+
+void World::printBorderInformation() {
+  /**
+   * Once the computation is done, the first row holds the input in base 2
+   * and the last column the output in base 3.
+   */
+  assert(inputType == BORDER);
+  ParityVectorSolver solver(inputStr);
+  BigInt input = solver.getBorderInput();
+  BigInt output = solver.getBorderOutput();
+  printf("The smallest number following the parity vector %s is %s, it is "
+         "mapped to %s.\n",
+         inputStr.c_str(), input.toReadout().c_str(),
+         output.toReadout().c_str());
+  if (!isComputationDone())
+    return;
+
+  std::string inputDigits = readRowOfBits();
+  std::string outputDigits = readColumnOfSums();
+  std::reverse(inputDigits.begin(), inputDigits.end());
+  std::reverse(outputDigits.begin(), outputDigits.end());
+  BigInt computedInput = BigInt::fromString(inputDigits, 2);
+  BigInt computedOutput = BigInt::fromString(outputDigits, 3);
+  if (computedInput == input && computedOutput == output)
+    printf("The simulation agrees with these numbers.\n");
+  else
+    printf("Mismatch: the simulation computed %s mapped to %s.\n",
+           computedInput.toReadout().c_str(),
+           computedOutput.toReadout().c_str());
 }
 
 std::vector<CellPosAndCell> World::findTweakSouthBorderUpdates() {
@@ -0,0 +1,64 @@
+/**
+ * Tiled storage of the world's cells.
+ */
+
+#include "../world.h"
+
+Tile &CellStore::getOrCreateTile(const Vector2i &cellPos) {
+  Tile *&tile = tiles[tileKey(cellPos)];
+  if (tile == NULL)
+    tile = newTile();
+  else if (arena)
+    arena->touch(tile);
+  return *tile;
+}
+
+Tile *CellStore::newTile() {
+  if (arena)
+    return arena->allocate();
+  return new Tile();
+}
+
+void CellStore::deleteTile(Tile *tile) {
+  if (arena)
+    arena->release(tile);
+  else
+    delete tile;
+}
+
+void CellStore::clear() {
+  if (arena)
+    arena->clear();
+  else
+    for (const auto &keyAndTile : tiles)
+      delete keyAndTile.second;
+  tiles.clear();
+  nbCells = 0;
+}
+
+void CellStore::mapToFile(const std::string &path, size_t residentBudget) {
+  assert(!arena);
+  arena.reset(new TileArena(path, residentBudget));
+  for (auto &keyAndTile : tiles) {
+    Tile *tile = arena->allocate();
+    memcpy(tile->packed, keyAndTile.second->packed, sizeof(tile->packed));
+    delete keyAndTile.second;
+    keyAndTile.second = tile;
+  }
+}
+
+int CellStore::countCells(const Tile &tile) {
+  int nbTileCells = 0;
+  for (int iCell = 0; iCell < TILE_SIDE * TILE_SIDE; iCell += 1)
+    nbTileCells += (tile.get(iCell) != PACKED_ABSENT);
+  return nbTileCells;
+}
+
+void CellStore::restoreTile(uint64_t key, const uint8_t *packed,
+                            size_t nbTileCells) {
+  Tile *&tile = tiles[key];
+  assert(tile == NULL);
+  tile = newTile();
+  memcpy(tile->packed, packed, sizeof(tile->packed));
+  nbCells += nbTileCells;
+}
@@ -0,0 +1,169 @@
+/**
+ * Packed trits engine for COL mode, see `col_engine.h`.
+ */
+
+#include "../col_engine.h"
+
+static const int TRITS_PER_BYTE = 5;
+static const int BYTE_BASE = 243; // 3^TRITS_PER_BYTE
+
+static const uint16_t *getHalvingTable() {
+  /**
+   * Entry `2 * byte + r` holds the half of r * 243 + `byte` in its 8 lowest
+   * bits and the remainder in the next one.
+   */
+  static uint16_t table[2 * BYTE_BASE];
+  static bool isInitialized = false;
+  if (!isInitialized) {
+    for (int byte = 0; byte < BYTE_BASE; byte += 1)
+      for (int r = 0; r < 2; r += 1) {
+        int value = r * BYTE_BASE + byte;
+        table[2 * byte + r] = (value / 2) | ((value % 2) << 8);
+      }
+    isInitialized = true;
+  }
+  return table;
+}
+
+static PackedCol halve(const PackedCol &col) {
+  /**
+   * Long division by 2 in base 243, most significant byte first.
+   */
+  const uint16_t *table = getHalvingTable();
+  PackedCol toRet;
+  toRet.firstByte = col.firstByte;
+  toRet.bytes.reserve(col.bytes.size());
+  int r = 0;
+  for (uint8_t byte : col.bytes) {
+    uint16_t entry = table[2 * byte + r];
+    r = entry >> 8;
+    if (toRet.bytes.empty() && (entry & 0xFF) == 0)
+      toRet.firstByte += 1;
+    else
+      toRet.bytes.push_back(entry & 0xFF);
+  }
+  return toRet;
+}
+
+ColEngine::ColEngine(const std::vector<int> &base3p) : inputCol(base3p) {
+  /**
+   * Column 0 holds the input, cells from y = -1 to y = -base3p.size().
+   */
+  height = static_cast<int>(base3p.size());
+  padding = (TRITS_PER_BYTE - height % TRITS_PER_BYTE) % TRITS_PER_BYTE;
+
+  // The sum of a base 3' digit is the base 3 digit
+  PackedCol col;
+  col.firstByte = 0;
+  col.bytes.assign((height + padding) / TRITS_PER_BYTE, 0);
+  for (int i = 0; i < height; i += 1) {
+    int digit = base3p[i] / 2 + base3p[i] % 2;
+    int iByte = (i + padding) / TRITS_PER_BYTE;
+    col.bytes[iByte] = col.bytes[iByte] * 3 + digit;
+  }
+  int nbBytes = static_cast<int>(col.bytes.size());
+  while (col.firstByte < nbBytes && col.bytes[col.firstByte] == 0)
+    col.firstByte += 1;
+  col.bytes.erase(col.bytes.begin(), col.bytes.begin() + col.firstByte);
+
+  rowEngine = RowEngine(toBinary(col));
+  cols.push_back(col);
+  nbCols = 1;
+}
+
+std::string ColEngine::toBinary(const PackedCol &col) const {
+  /**
+   * Base 3 -> base 2 conversion of a column, its bytes are base 243 digits.
+   */
+  std::vector<uint32_t> digits(col.bytes.begin(), col.bytes.end());
+  return BigInt::fromDigits(digits, BYTE_BASE).toBase2();
+}
+
+void ColEngine::next() {
+  if (height == 0)
+    return;
+  cols.push_back(halve(cols.back()));
+  nbCols += 1;
+  rowEngine.next();
+}
+
+void ColEngine::advance(int nbSteps) {
+  if (height == 0)
+    return;
+  for (int iStep = 0; iStep < nbSteps; iStep += 1) {
+    cols.push_back(halve(cols.back()));
+    nbCols += 1;
+  }
+  rowEngine.advance(nbSteps);
+}
+
+const PackedCol &ColEngine::getCol(int iCol) const {
+  int firstCol = nbCols - static_cast<int>(cols.size());
+  assert(iCol >= firstCol && iCol < nbCols);
+  return cols[iCol - firstCol];
+}
+
+int ColEngine::getTrit(const PackedCol &col, int y) const {
+  int i = height + y + padding;
+  int iByte = i / TRITS_PER_BYTE - col.firstByte;
+  if (iByte < 0)
+    return 0;
+  int byte = col.bytes[iByte];
+  for (int iTrit = i % TRITS_PER_BYTE; iTrit < TRITS_PER_BYTE - 1; iTrit += 1)
+    byte /= 3;
+  return byte % 3;
+}
+
+int ColEngine::getColTop(int iCol) const {
+  /**
+   * As in the CA, a column starts west of the northernmost non zero cell of
+   * the column east of it. Column -1 is bootstrapped at the top.
+   */
+  if (iCol <= 1)
+    return -height;
+  const PackedCol &east = getCol(iCol - 1);
+  if (east.bytes.empty())
+    return 0;
+  int y = (east.firstByte * TRITS_PER_BYTE) - padding - height;
+  while (getTrit(east, y) == 0)
+    y += 1;
+  return y;
+}
+
+void ColEngine::materializeCol(
+    int iCol, std::vector<std::pair<Vector2i, Cell>> &out) const {
+  /**
+   * Produces the cells of column x = -iCol north of row 0 as the CA would
+   * have computed them.
+   */
+  if (iCol == 0) {
+    for (int y = -1; y >= -height; y -= 1) {
+      int current = inputCol[height + y];
+      out.push_back(std::make_pair(
+          Vector2i(0, y), Cell(static_cast<AtomicInfo>(current / 2),
+                               static_cast<AtomicInfo>(current % 2))));
+    }
+    return;
+  }
+
+  // The bit of a cell is the remainder of the division by 2 of the trits
+  // north of it in the east column
+  const PackedCol &east = getCol(iCol - 1);
+  int r = 0;
+  for (int y = getColTop(iCol); y < 0; y += 1) {
+    int trit = getTrit(east, y);
+    Cell cell(static_cast<AtomicInfo>(r),
+              static_cast<AtomicInfo>((r + trit) / 2));
+    out.push_back(std::make_pair(Vector2i(-iCol, y), cell));
+    r = (r + trit) % 2;
+  }
+
+  // Input 0 never reaches row 0: its last cell stays half defined
+  if (iCol == 1 && rowEngine.getNbRows() == 0)
+    out.push_back(std::make_pair(Vector2i(-1, 0), Cell(ZERO, UNDEF)));
+}
+
+void ColEngine::forgetColsBefore(int iCol) {
+  while (cols.size() > 1 && nbCols - static_cast<int>(cols.size()) < iCol)
+    cols.pop_front();
+}
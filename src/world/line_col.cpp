@@ -19,10 +19,18 @@ void World::setInputCellsLine() {
              current);
       exit(0);
     }
-    sf::Vector2i posToAdd = {x, 0};
+    Vector2i posToAdd = {x, 0};
     Cell cellToAdd = Cell(static_cast<AtomicInfo>(current - '0'), UNDEF);
     updates.push_back(std::make_pair(posToAdd, cellToAdd));
   }
+
+  if (isFastEngineEnabled) {
+    rowEngine = RowEngine(inputStr);
+    nbMaterializedRows = 0;
+    updateFastEngineEdge();
+    return;
+  }
+
   applyUpdates(updates);
 
   // Tweak to bootstrap the process when input has trailing 0s
@@ -32,6 +40,107 @@ void World::setInputCellsLine() {
   if (x == inputStr.length())
     return;
   cellsOnEdge.insert({-x - 1, 0});
+  edgeCandidates.push_back({-x - 1, 0});
+}
+
+void World::advanceByMacroBlocks(int nbSteps) {
+  /**
+   * Runs `nbSteps` steps of the CA on the macro blocks, see
+   * `macro_blocks.h`, then writes the cells which changed. The cells and the
+   * edge are the same as after `nbSteps` calls to `next`.
+   */
+  PROFILE_PHASE(PHASE_MACRO_BLOCKS);
+  int firstRow = INT_MAX;
+  for (const Vector2i &cellPos : cellsOnEdge)
+    firstRow = MIN(firstRow, cellPos.y);
+  // Without edge, no rule applies anymore
+  if (firstRow != INT_MAX) {
+    // Rows north of the edge are defined, only the last of them is read
+    firstRow -= 1;
+    std::vector<MacroCell> region;
+    for (const auto &row : rowSummaries) {
+      if (row.first < firstRow)
+        continue;
+      for (int x = row.second.minX; x <= row.second.maxX; x += 1) {
+        Vector2i cellPos(x, row.first);
+        uint8_t packed = cells.getPacked(cellPos);
+        if (packed == PACKED_ABSENT)
+          continue;
+        if (isThereOneEastOf(cellPos))
+          packed |= MACRO_ONE_EAST_FLAG;
+        region.push_back(std::make_pair(cellPos, packed));
+      }
+    }
+    macroBlocks.advance(region, nbSteps);
+
+    // The non local rule also defines the 0s east of the bootstrapping carry
+    std::unordered_map<int, int> bootstrappingX; // Per row
+    for (const MacroCell &cell : region)
+      if (cell.second & PACKED_BOOTSTRAPPING_FLAG)
+        bootstrappingX[cell.first.y] = cell.first.x;
+    std::vector<CellPosAndCell> updates;
+    for (const MacroCell &cell : region) {
+      const Vector2i &cellPos = cell.first;
+      uint8_t packed = cell.second & ~MACRO_ONE_EAST_FLAG;
+      if (packed == PACKED_HALF_DEFINED) {
+        auto it = bootstrappingX.find(cellPos.y);
+        if (it != bootstrappingX.end() && it->second < cellPos.x)
+          packed = packCell(Cell(ZERO, ZERO));
+      }
+      if (packed != cells.getPacked(cellPos))
+        updates.push_back(std::make_pair(cellPos, unpackCell(packed)));
+    }
+    PROFILE_UPDATES(PHASE_MACRO_BLOCKS, updates.size());
+    applyUpdates(updates);
+  }
+  this->nbSteps += nbSteps;
+  PROFILE_END_STEPS(nbSteps);
+}
+
+void World::updateFastEngineEdge() {
+  /**
+   * With the fast engines, the edge is reduced to the east end of the last
+   * computed row and, in COL mode, the top of the last computed column.
+   */
+  assert(isFastEngineEnabled);
+  cellsOnEdge.clear();
+  RowEngine &engine = (inputType == COL) ? colEngine.rowEngine : rowEngine;
+  if (engine.getNbRows() != 0) {
+    const PackedRow &lastRow = engine.getRow(engine.getNbRows() - 1);
+    cellsOnEdge.insert({lastRow.eastX, lastRow.y});
+  }
+  if (inputType == COL) {
+    int iCol = colEngine.getNbCols() - 1;
+    int top = colEngine.getColTop(iCol);
+    if (top < 0)
+      cellsOnEdge.insert({-iCol, top});
+  }
+}
+
+void World::materialize() {
+  /**
+   * Writes the cells of all the rows and columns computed by the fast
+   * engines since last call to `cells`. The CA would have computed the exact
+   * same cells.
+   */
+  if (!isFastEngineEnabled)
+    return;
+  std::vector<CellPosAndCell> newCells;
+  if (inputType == COL) {
+    for (; nbMaterializedCols < colEngine.getNbCols(); nbMaterializedCols += 1)
+      colEngine.materializeCol(nbMaterializedCols, newCells);
+    colEngine.forgetColsBefore(nbMaterializedCols - 1);
+  }
+  RowEngine &engine = (inputType == COL) ? colEngine.rowEngine : rowEngine;
+  for (; nbMaterializedRows < engine.getNbRows(); nbMaterializedRows += 1)
+    engine.materializeRow(nbMaterializedRows, newCells);
+  engine.forgetRowsBefore(nbMaterializedRows - 1);
+
+  for (const auto &info : newCells) {
+    cells.set(info.first, info.second);
+    if (isGraphicBufferEnabled)
+      cellGraphicBuffer.push_back(info.first);
+  }
 }
 
 void World::setInputCellsCol() {
@@ -43,14 +152,22 @@ void World::setInputCellsCol() {
   std::vector<int> base3p = base3To3p(inputStr);
   for (int y = -1; y >= -1 * base3p.size(); y -= 1) {
     int current = base3p[base3p.size() + y];
-    sf::Vector2i posToAdd = {0, y};
+    Vector2i posToAdd = {0, y};
     Cell cellToAdd = Cell(static_cast<AtomicInfo>(current / 2),
                           static_cast<AtomicInfo>(current % 2));
     updates.push_back(std::make_pair(posToAdd, cellToAdd));
   }
 
+  if (isFastEngineEnabled) {
+    colEngine = ColEngine(base3p);
+    nbMaterializedCols = 0;
+    nbMaterializedRows = 0;
+    updateFastEngineEdge();
+    return;
+  }
+
   // Bootstrapping col mode, this is the first half defined cell
-  sf::Vector2i posToAdd = {-1, -1 * static_cast<int>(base3p.size())};
+  Vector2i posToAdd = {-1, -1 * static_cast<int>(base3p.size())};
   Cell cellToAdd = {ZERO, UNDEF};
   updates.push_back(std::make_pair(posToAdd, cellToAdd));
 
@@ -63,7 +180,7 @@ void World::setInputCellsCol() {
 }
 
 void World::manageEdgeCases(std::vector<CellPosAndCell> &toRet,
-                            const sf::Vector2i &cellPos,
+                            const Vector2i &cellPos,
                             const Cell &updatedCell) {
   if (inputType == LINE) {
     // Edge case at end of a line which is in theory (0)^\infty
@@ -76,19 +193,121 @@ void World::manageEdgeCases(std::vector<CellPosAndCell> &toRet,
   if (inputType == COL) {
     // Edge case at beginning of a column which is in theory (0)^\infty
     if (!doesCellExists(cellPos + WEST) && updatedCell.sum() != 0) {
-      bool onlyZero = true;
-      sf::Vector2i currentPos = cellPos + NORTH;
-      while (doesCellExists(currentPos)) {
-        assert(cells[currentPos].getStatus() == DEFINED);
-        if (cells[currentPos].sum() != 0) {
-          onlyZero = false;
-          break;
-        }
-        currentPos += NORTH;
-      }
-      if (onlyZero) {
+      if (isOnlyZeroNorthOf(cellPos)) {
         toRet.push_back(std::make_pair(cellPos + WEST, Cell(ZERO, UNDEF)));
       }
     }
   }
-}
\ No newline at end of file
+}
+
+static bool isNonZero(const Cell &cell) {
+  return cell.getStatus() == DEFINED && cell.sum() != 0;
+}
+
+void World::updateColSummary(const Vector2i &cellPos, bool wasPresent,
+                             const Cell &oldCell, const Cell &newCell) {
+  /**
+   * Keeps the summary of the column of `cellPos` up to date after a write.
+   */
+  assert(inputType == COL);
+  ColSummary &col = colSummaries[cellPos.x];
+  if (!wasPresent) {
+    col.nbCells += 1;
+    col.minY = MIN(col.minY, cellPos.y);
+    col.maxY = MAX(col.maxY, cellPos.y);
+  }
+  if (isNonZero(newCell)) {
+    col.topmostNonZero = MIN(col.topmostNonZero, cellPos.y);
+  } else if (wasPresent && isNonZero(oldCell) &&
+             cellPos.y == col.topmostNonZero) {
+    // Should not happen in practice: look for the next non zero cell
+    col.topmostNonZero = INT_MAX;
+    for (int y = cellPos.y + 1; y <= col.maxY; y += 1)
+      if (isNonZero(cells[{cellPos.x, y}])) {
+        col.topmostNonZero = y;
+        break;
+      }
+  }
+}
+
+bool World::isOnlyZeroNorthOf(const Vector2i &cellPos) {
+  /**
+   * Are all the contiguous cells north of `cellPos` defined with a zero sum?
+   */
+  const auto it = colSummaries.find(cellPos.x);
+  if (it != colSummaries.end() && it->second.isContiguous())
+    return it->second.topmostNonZero >= cellPos.y;
+
+  // Holes in the column: walk to the first non zero cell
+  Vector2i currentPos = cellPos + NORTH;
+  while (doesCellExists(currentPos)) {
+    assert(cells[currentPos].getStatus() == DEFINED);
+    if (cells[currentPos].sum() != 0)
+      return false;
+    currentPos += NORTH;
+  }
+  return true;
+}
+
+Vector2i
+World::printBaseConversion(std::vector<Vector2i> &outlinedCells) {
+  /**
+   * Row and col modes: the column north of the target cell is a base 3'
+   * encoding and the row west of it a base 2 encoding of the same number.
+   */
+  assert(inputType == LINE || inputType == COL);
+
+  // Heuristic bound to have all the necessary cells on the screen
+  advance(4 * inputStr.size());
+  materialize();
+
+  Vector2i targetCell = {0, 0};
+  if (inputType == LINE) {
+    targetCell = {-1 * static_cast<int>(inputStr.size()), 0};
+    while (doesCellExists(targetCell) && doesCellExists(targetCell + SOUTH))
+      targetCell += SOUTH;
+  }
+
+  std::string base2Row, base3Col;
+  Vector2i currentPos = targetCell + NORTH;
+
+  outlinedCells.clear();
+  while (doesCellExists(currentPos)) {
+    base3Col += '0' + cells[currentPos].sum();
+    outlinedCells.push_back(currentPos);
+    currentPos += NORTH;
+  }
+  std::reverse(base3Col.begin(), base3Col.end());
+
+  currentPos = targetCell + WEST;
+  while (doesCellExists(currentPos)) {
+    base2Row += '0' + static_cast<char>(cells[currentPos].bit);
+    outlinedCells.push_back(currentPos);
+    currentPos += WEST;
+  }
+
+  // Remove head 0s
+  currentPos += EAST;
+  while (!base2Row.empty() && doesCellExists(currentPos) &&
+         cells[currentPos].bit == ZERO) {
+    outlinedCells.pop_back();
+    base2Row.erase(base2Row.size() - 1);
+    currentPos += EAST;
+  }
+
+  std::reverse(base2Row.begin(), base2Row.end());
+
+  // Arbitrary precision: both numbers are compared whatever their size
+  BigInt z3 = BigInt::fromString(base3Col, 3);
+  BigInt z2 = BigInt::fromString(base2Row, 2);
+  printf("\n");
+  printf("The outlined vertical column is a base 3' encoding of: `%s` = %s\n",
+         base3Col.c_str(), z3.toReadout().c_str());
+  printf("The outlined horizontal row is a base 2 encoding of: `%s` = %s\n",
+         base2Row.c_str(), z2.toReadout().c_str());
+  if (z3 == z2)
+    printf("Both represent the number: %s\n\n", z3.toReadout().c_str());
+  else
+    printf("They do not represent the same number.\n\n");
+  return targetCell;
+}
@@ -0,0 +1,395 @@
+/**
+ * HashLife-style simulation of the LINE mode CA, see `macro_blocks.h`.
+ */
+
+#include "../macro_blocks.h"
+
+static inline bool isPresent(uint8_t cell) {
+  return (cell & ~MACRO_ONE_EAST_FLAG) != PACKED_ABSENT;
+}
+
+static inline bool isHalfDefined(uint8_t cell) {
+  cell &= 7;
+  return cell >= PACKED_HALF_DEFINED && cell < PACKED_DEFINED;
+}
+
+static inline bool isDefined(uint8_t cell) {
+  return (cell & 7) >= PACKED_DEFINED;
+}
+
+static inline int bitOf(uint8_t cell) {
+  if (isDefined(cell))
+    return ((cell & 7) - PACKED_DEFINED) / 2;
+  return (cell & 7) - PACKED_HALF_DEFINED;
+}
+
+static inline int sumOf(uint8_t cell) {
+  return bitOf(cell) + ((cell & 7) - PACKED_DEFINED) % 2;
+}
+
+static inline uint8_t oneEastFlagOf(uint8_t eastCell) {
+  /**
+   * Flag of the cell west of `eastCell`.
+   */
+  if (!isPresent(eastCell))
+    return 0;
+  if (bitOf(eastCell) == 1 || (eastCell & MACRO_ONE_EAST_FLAG))
+    return MACRO_ONE_EAST_FLAG;
+  return 0;
+}
+
+static inline bool isCarryPropagated(const BaseGrid &grid, int x, int y) {
+  return isHalfDefined(grid[y][x]) && x + 1 < BASE_SIDE &&
+         isDefined(grid[y][x + 1]);
+}
+
+static void stepGrid(BaseGrid &grid) {
+  /**
+   * One step of the CA, as `World::next` does it: the non local rule is
+   * applied first, then carry propagation and forward deduction are both
+   * found before being applied. Cells out of the grid are absent.
+   */
+  BaseGrid current;
+  memcpy(current, grid, sizeof(BaseGrid));
+  for (int y = 0; y < BASE_SIDE; y += 1)
+    for (int x = 0; x + 1 < BASE_SIDE; x += 1) {
+      uint8_t cell = current[y][x];
+      if (isHalfDefined(cell) && bitOf(cell) == 1 &&
+          !(cell & MACRO_ONE_EAST_FLAG) && !isDefined(current[y][x + 1]))
+        grid[y][x + 1] = (PACKED_DEFINED + 1) | PACKED_BOOTSTRAPPING_FLAG |
+                         (current[y][x + 1] & MACRO_ONE_EAST_FLAG);
+    }
+
+  // Forward deduction updates are applied after the carry propagation ones
+  memcpy(current, grid, sizeof(BaseGrid));
+  for (int y = 0; y < BASE_SIDE; y += 1)
+    for (int x = 0; x < BASE_SIDE; x += 1) {
+      if (!isCarryPropagated(current, x, y))
+        continue;
+      uint8_t cell = current[y][x];
+      int bit = bitOf(cell);
+      int carry = (bit + sumOf(current[y][x + 1])) >= 2;
+      grid[y][x] =
+          (PACKED_DEFINED + 2 * bit + carry) | (cell & MACRO_ONE_EAST_FLAG);
+
+      // Edge case at the west end of a line
+      bool isNorthWestPresent =
+          y > 0 && x > 0 && isPresent(current[y - 1][x - 1]);
+      if (x > 0 && !isPresent(current[y][x - 1]) && !isNorthWestPresent &&
+          bit + carry >= 1)
+        grid[y][x - 1] = PACKED_HALF_DEFINED | oneEastFlagOf(cell);
+    }
+  for (int y = 0; y + 1 < BASE_SIDE; y += 1)
+    for (int x = 0; x < BASE_SIDE; x += 1) {
+      if (!isCarryPropagated(current, x, y))
+        continue;
+      int southBit = (bitOf(current[y][x]) + sumOf(current[y][x + 1])) % 2;
+      grid[y + 1][x] = (PACKED_HALF_DEFINED + southBit) |
+                       oneEastFlagOf(current[y + 1][x + 1]);
+    }
+}
+
+void MacroBlocks::clear() {
+  blocks.clear();
+  leaves.clear();
+  blockIds.clear();
+  leafIds.clear();
+  results.clear();
+  emptyBlocks.clear();
+}
+
+uint32_t MacroBlocks::leaf(const LeafCells &cells) {
+  auto it = leafIds.find(cells);
+  if (it != leafIds.end())
+    return it->second;
+  MacroBlock block;
+  block.nw = block.ne = block.sw = block.se = leaves.size();
+  block.level = MACRO_LEAF_LEVEL;
+  block.hasHalfDefinedCells = false;
+  for (uint8_t cell : cells)
+    if (isHalfDefined(cell))
+      block.hasHalfDefinedCells = true;
+  leaves.push_back(cells);
+  uint32_t id = blocks.size();
+  blocks.push_back(block);
+  leafIds[cells] = id;
+  return id;
+}
+
+uint32_t MacroBlocks::join(uint32_t nw, uint32_t ne, uint32_t sw,
+                           uint32_t se) {
+  MacroBlockKey key = {nw, ne, sw, se};
+  auto it = blockIds.find(key);
+  if (it != blockIds.end())
+    return it->second;
+  MacroBlock block;
+  block.nw = nw;
+  block.ne = ne;
+  block.sw = sw;
+  block.se = se;
+  block.level = blocks[nw].level + 1;
+  block.hasHalfDefinedCells =
+      blocks[nw].hasHalfDefinedCells || blocks[ne].hasHalfDefinedCells ||
+      blocks[sw].hasHalfDefinedCells || blocks[se].hasHalfDefinedCells;
+  uint32_t id = blocks.size();
+  blocks.push_back(block);
+  blockIds[key] = id;
+  return id;
+}
+
+uint32_t MacroBlocks::empty(int level) {
+  size_t index = level - MACRO_LEAF_LEVEL;
+  while (emptyBlocks.size() <= index) {
+    if (emptyBlocks.empty()) {
+      LeafCells cells;
+      cells.fill(PACKED_ABSENT);
+      emptyBlocks.push_back(leaf(cells));
+    } else {
+      uint32_t child = emptyBlocks.back();
+      emptyBlocks.push_back(join(child, child, child, child));
+    }
+  }
+  return emptyBlocks[index];
+}
+
+void MacroBlocks::readBaseBlock(uint32_t id, BaseGrid &grid) const {
+  const MacroBlock &block = blocks[id];
+  assert(block.level == BASE_LEVEL);
+  const uint32_t quadrants[4] = {block.nw, block.ne, block.sw, block.se};
+  for (int iQuadrant = 0; iQuadrant < 4; iQuadrant += 1) {
+    const LeafCells &cells = leaves[blocks[quadrants[iQuadrant]].nw];
+    int xOffset = (iQuadrant % 2) * MACRO_LEAF_SIDE;
+    int yOffset = (iQuadrant / 2) * MACRO_LEAF_SIDE;
+    for (int y = 0; y < MACRO_LEAF_SIDE; y += 1)
+      for (int x = 0; x < MACRO_LEAF_SIDE; x += 1)
+        grid[yOffset + y][xOffset + x] = cells[y * MACRO_LEAF_SIDE + x];
+  }
+}
+
+uint32_t MacroBlocks::leafAtCenter(const BaseGrid &grid) {
+  const int offset = MACRO_LEAF_SIDE / 2;
+  LeafCells cells;
+  for (int y = 0; y < MACRO_LEAF_SIDE; y += 1)
+    for (int x = 0; x < MACRO_LEAF_SIDE; x += 1)
+      cells[y * MACRO_LEAF_SIDE + x] = grid[offset + y][offset + x];
+  return leaf(cells);
+}
+
+uint32_t MacroBlocks::center(uint32_t id) {
+  /**
+   * Square of half the side of the block, at its center.
+   */
+  const MacroBlock block = blocks[id];
+  if (block.level > BASE_LEVEL)
+    return join(blocks[block.nw].se, blocks[block.ne].sw,
+                blocks[block.sw].ne, blocks[block.se].nw);
+  BaseGrid grid;
+  readBaseBlock(id, grid);
+  return leafAtCenter(grid);
+}
+
+uint32_t MacroBlocks::stepBaseBlock(uint32_t id, int nbSteps) {
+  /**
+   * Center of a base block `nbSteps` steps later, at most 2 steps so that
+   * the cells the center reads are all in the block.
+   */
+  assert(nbSteps <= 2);
+  BaseGrid grid;
+  readBaseBlock(id, grid);
+  for (int iStep = 0; iStep < nbSteps; iStep += 1)
+    stepGrid(grid);
+  nbSteppedCells += MACRO_LEAF_SIDE * MACRO_LEAF_SIDE * nbSteps;
+  return leafAtCenter(grid);
+}
+
+uint32_t MacroBlocks::result(uint32_t id, int log2NbSteps) {
+  /**
+   * Center of the block 2^`log2NbSteps` steps later, at most 2^(level-3)
+   * steps. As in HashLife, the center is computed from nine overlapping sub
+   * blocks advanced half way, assembled into four blocks advanced the rest
+   * of the way. For fewer steps, only the second half advances.
+   */
+  const MacroBlock block = blocks[id];
+  assert(log2NbSteps <= block.level - 3);
+  if (!block.hasHalfDefinedCells)
+    return center(id);
+  uint64_t key = (static_cast<uint64_t>(id) << 8) | log2NbSteps;
+  auto it = results.find(key);
+  if (it != results.end())
+    return it->second;
+
+  uint32_t toRet;
+  if (block.level == BASE_LEVEL) {
+    toRet = stepBaseBlock(id, 1 << log2NbSteps);
+  } else {
+    const MacroBlock nw = blocks[block.nw], ne = blocks[block.ne],
+                     sw = blocks[block.sw], se = blocks[block.se];
+    uint32_t subBlocks[3][3] = {
+        {block.nw, join(nw.ne, ne.nw, nw.se, ne.sw), block.ne},
+        {join(nw.sw, nw.se, sw.nw, sw.ne), join(nw.se, ne.sw, sw.ne, se.nw),
+         join(ne.sw, ne.se, se.nw, se.ne)},
+        {block.sw, join(sw.ne, se.nw, sw.se, se.sw), block.se}};
+    bool isFullStep = log2NbSteps == block.level - 3;
+    int log2HalfSteps = isFullStep ? log2NbSteps - 1 : log2NbSteps;
+    uint32_t halfWay[3][3];
+    for (int y = 0; y < 3; y += 1)
+      for (int x = 0; x < 3; x += 1)
+        halfWay[y][x] = isFullStep ? result(subBlocks[y][x], log2HalfSteps)
+                                   : center(subBlocks[y][x]);
+    uint32_t quadrants[2][2];
+    for (int y = 0; y < 2; y += 1)
+      for (int x = 0; x < 2; x += 1)
+        quadrants[y][x] = result(join(halfWay[y][x], halfWay[y][x + 1],
+                                      halfWay[y + 1][x], halfWay[y + 1][x + 1]),
+                                 log2HalfSteps);
+    toRet = join(quadrants[0][0], quadrants[0][1], quadrants[1][0],
+                 quadrants[1][1]);
+  }
+  results[key] = toRet;
+  return toRet;
+}
+
+uint32_t MacroBlocks::expand(uint32_t id) {
+  /**
+   * Block of twice the side with the block at its center.
+   */
+  const MacroBlock block = blocks[id];
+  uint32_t border = empty(block.level - 1);
+  return join(join(border, border, border, block.nw),
+              join(border, border, block.ne, border),
+              join(border, block.sw, border, border),
+              join(block.se, border, border, border));
+}
+
+bool MacroBlocks::isCentered(uint32_t id) {
+  /**
+   * Are all the cells of the block in the square of a quarter of its side at
+   * its center? That is the middle of its four central grandchildren.
+   */
+  const MacroBlock block = blocks[id];
+  if (block.level < BASE_LEVEL + 2)
+    return false;
+  uint32_t border = empty(block.level - 2);
+  const MacroBlock nw = blocks[block.nw], ne = blocks[block.ne],
+                   sw = blocks[block.sw], se = blocks[block.se];
+  if (nw.nw != border || nw.ne != border || nw.sw != border ||
+      ne.nw != border || ne.ne != border || ne.se != border ||
+      sw.nw != border || sw.sw != border || sw.se != border ||
+      se.ne != border || se.sw != border || se.se != border)
+    return false;
+  border = empty(block.level - 3);
+  const MacroBlock nwCenter = blocks[nw.se], neCenter = blocks[ne.sw],
+                   swCenter = blocks[sw.ne], seCenter = blocks[se.nw];
+  return nwCenter.nw == border && nwCenter.ne == border &&
+         nwCenter.sw == border && neCenter.nw == border &&
+         neCenter.ne == border && neCenter.se == border &&
+         swCenter.nw == border && swCenter.sw == border &&
+         swCenter.se == border && seCenter.ne == border &&
+         seCenter.sw == border && seCenter.se == border;
+}
+
+uint32_t MacroBlocks::build(const std::vector<MacroCell> &cells,
+                            Vector2i &origin) {
+  /**
+   * Quadtree of `cells`, `origin` is set to its north west cell.
+   */
+  origin = cells[0].first;
+  for (const MacroCell &cell : cells) {
+    origin.x = MIN(origin.x, cell.first.x);
+    origin.y = MIN(origin.y, cell.first.y);
+  }
+
+  // Blocks of the current level, keyed on their position in blocks
+  std::unordered_map<uint64_t, LeafCells> leafCells;
+  for (const MacroCell &cell : cells) {
+    Vector2i pos = cell.first - origin;
+    uint64_t key = packPos(
+        Vector2i(pos.x >> MACRO_LEAF_LEVEL, pos.y >> MACRO_LEAF_LEVEL));
+    auto it = leafCells.find(key);
+    if (it == leafCells.end()) {
+      it = leafCells.insert(std::make_pair(key, LeafCells())).first;
+      it->second.fill(PACKED_ABSENT);
+    }
+    it->second[(pos.y % MACRO_LEAF_SIDE) * MACRO_LEAF_SIDE +
+               pos.x % MACRO_LEAF_SIDE] = cell.second;
+  }
+  std::unordered_map<uint64_t, uint32_t> levelBlocks;
+  for (const auto &keyAndCells : leafCells)
+    levelBlocks[keyAndCells.first] = leaf(keyAndCells.second);
+
+  int level = MACRO_LEAF_LEVEL;
+  while (level < BASE_LEVEL + 1 || levelBlocks.size() > 1 ||
+         levelBlocks.begin()->first != 0) {
+    std::unordered_map<uint64_t, std::array<uint32_t, 4>> parents;
+    for (const auto &keyAndBlock : levelBlocks) {
+      int x = static_cast<int>(keyAndBlock.first >> 32);
+      int y = static_cast<int>(keyAndBlock.first & 0xFFFFFFFF);
+      uint64_t key = packPos(Vector2i(x / 2, y / 2));
+      auto it = parents.find(key);
+      if (it == parents.end()) {
+        it = parents.insert(std::make_pair(key, std::array<uint32_t, 4>()))
+                 .first;
+        it->second.fill(empty(level));
+      }
+      it->second[(y % 2) * 2 + x % 2] = keyAndBlock.second;
+    }
+    levelBlocks.clear();
+    for (const auto &keyAndChildren : parents) {
+      const std::array<uint32_t, 4> &children = keyAndChildren.second;
+      levelBlocks[keyAndChildren.first] =
+          join(children[0], children[1], children[2], children[3]);
+    }
+    level += 1;
+  }
+  return levelBlocks.begin()->second;
+}
+
+void MacroBlocks::extract(uint32_t id, const Vector2i &origin,
+                          std::vector<MacroCell> &cells) {
+  const MacroBlock block = blocks[id];
+  if (block.level == MACRO_LEAF_LEVEL) {
+    const LeafCells &leafCells = leaves[block.nw];
+    for (int iCell = 0; iCell < MACRO_LEAF_SIDE * MACRO_LEAF_SIDE; iCell += 1)
+      if (isPresent(leafCells[iCell]))
+        cells.push_back(
+            std::make_pair(origin + Vector2i(iCell % MACRO_LEAF_SIDE,
+                                             iCell / MACRO_LEAF_SIDE),
+                           leafCells[iCell]));
+    return;
+  }
+  if (id == empty(block.level))
+    return;
+  int half = 1 << (block.level - 1);
+  extract(block.nw, origin, cells);
+  extract(block.ne, origin + Vector2i(half, 0), cells);
+  extract(block.sw, origin + Vector2i(0, half), cells);
+  extract(block.se, origin + Vector2i(half, half), cells);
+}
+
+void MacroBlocks::advance(std::vector<MacroCell> &cells, int nbSteps) {
+  /**
+   * Advances by the powers of 2 of `nbSteps`. Before each of them the root
+   * is expanded until its cells are far enough from the border of its
+   * center: cells are created at most one cell away per step.
+   */
+  if (cells.empty())
+    return;
+  if (blocks.size() > MAX_NB_MACRO_BLOCKS)
+    clear();
+  Vector2i origin;
+  uint32_t root = build(cells, origin);
+  for (int log2NbSteps = 0; (nbSteps >> log2NbSteps) != 0; log2NbSteps += 1) {
+    if (!((nbSteps >> log2NbSteps) & 1))
+      continue;
+    while (blocks[root].level < log2NbSteps + 3 || !isCentered(root)) {
+      int half = 1 << (blocks[root].level - 1);
+      root = expand(root);
+      origin -= Vector2i(half, half);
+    }
+    int quarter = 1 << (blocks[root].level - 2);
+    root = result(root, log2NbSteps);
+    origin += Vector2i(quarter, quarter);
+  }
+  cells.clear();
+  extract(root, origin, cells);
+}
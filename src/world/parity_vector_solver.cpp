@@ -0,0 +1,136 @@
+/**
+ * Analytic solutions of cycle and border modes, see `parity_vector_solver.h`.
+ */
+
+#include "../parity_vector_solver.h"
+
+#include <algorithm>
+#include <cassert>
+
+char PAdicExpansion::digitAt(size_t iDigit) const {
+  if (iDigit < initialSegment.size())
+    return initialSegment[iDigit];
+  return period[(iDigit - initialSegment.size()) % period.size()];
+}
+
+ParityVectorSolver::ParityVectorSolver(const std::string &parityVector)
+    : parityVector(parityVector) {
+  compose(0, parityVector.size(), c, powerOf3);
+  BigInt powerOf2 = BigInt(1) << parityVector.size();
+  isDenominatorNegative = powerOf2 < powerOf3;
+  denominator = isDenominatorNegative ? powerOf3 - powerOf2
+                                      : powerOf2 - powerOf3;
+}
+
+void ParityVectorSolver::compose(size_t iStart, size_t iEnd, BigInt &cPart,
+                                 BigInt &powerOf3Part) const {
+  /**
+   * Following the first part then the second part of the vector maps x to
+   * (3^k2 (3^k1 x + C1) / 2^n1 + C2) / 2^n2, hence C = 3^k2 C1 + 2^n1 C2.
+   */
+  if (iEnd - iStart <= PARITY_BITS_PER_LEAF) {
+    cPart = BigInt();
+    powerOf3Part = BigInt(1);
+    for (size_t iBit = iStart; iBit < iEnd; iBit += 1)
+      if (parityVector[iBit] == '1') {
+        cPart = cPart * BigInt(3) + (BigInt(1) << (iBit - iStart));
+        powerOf3Part = powerOf3Part * BigInt(3);
+      }
+    return;
+  }
+  size_t iMiddle = iStart + (iEnd - iStart) / 2;
+  BigInt firstC, firstPowerOf3, secondC, secondPowerOf3;
+  compose(iStart, iMiddle, firstC, firstPowerOf3);
+  compose(iMiddle, iEnd, secondC, secondPowerOf3);
+  cPart = secondPowerOf3 * firstC + (secondC << (iMiddle - iStart));
+  powerOf3Part = firstPowerOf3 * secondPowerOf3;
+}
+
+PAdicExpansion ParityVectorSolver::expandCycle(uint32_t base) const {
+  /**
+   * Digits of a / b, b > 0 coprime to the base: the digit is a / b modulo
+   * the base, then a becomes (a - digit b) / base. Once -b <= a <= 0 the
+   * expansion is purely periodic: the period ends when a comes back.
+   */
+  assert(base == 2 || base == 3);
+  BigInt a = c;
+  bool isANegative = isDenominatorNegative && !c.isZero();
+  uint32_t bInverse = base == 2 ? 1 : denominator.modulo3(); // Self inverse
+  BigInt multiplesOfB[3] = {BigInt(), denominator, denominator + denominator};
+
+  PAdicExpansion toRet;
+  toRet.isPeriodComplete = false;
+  BigInt periodStart;
+  bool isPeriodic = false;
+  while (toRet.period.size() < MAX_EXPANSION_PERIOD) {
+    if (!isPeriodic && (a.isZero() || (isANegative && !(denominator < a)))) {
+      isPeriodic = true;
+      periodStart = a;
+    }
+
+    uint32_t digit = base == 2 ? a.isOdd() : a.modulo3();
+    if (isANegative && digit != 0)
+      digit = base - digit;
+    digit = digit * bInverse % base;
+
+    const BigInt &toSubtract = multiplesOfB[digit];
+    if (digit != 0 && isANegative)
+      a = a + toSubtract;
+    else if (digit != 0 && !(a < toSubtract))
+      a = a - toSubtract;
+    else if (digit != 0) {
+      a = toSubtract - a;
+      isANegative = true;
+    }
+    if (base == 2)
+      a = a >> 1;
+    else
+      a.divideExactlyBy(3);
+    isANegative &= !a.isZero();
+
+    if (isPeriodic)
+      toRet.period.push_back('0' + digit);
+    else
+      toRet.initialSegment.push_back('0' + digit);
+    if (isPeriodic && a == periodStart) {
+      toRet.isPeriodComplete = true;
+      break;
+    }
+  }
+  return toRet;
+}
+
+static BigInt inverseModPowerOf2(const BigInt &a, size_t nbBits) {
+  /**
+   * Newton iteration inv <- inv (2 - a inv), each step doubles the number
+   * of correct low bits. `a` must be odd.
+   */
+  BigInt inverse(1);
+  for (size_t precision = 1; precision < nbBits;) {
+    precision = std::min(2 * precision, nbBits);
+    BigInt product = (a.lowBits(precision) * inverse).lowBits(precision);
+    BigInt correction =
+        ((BigInt(1) << precision) + BigInt(2) - product).lowBits(precision);
+    inverse = (inverse * correction).lowBits(precision);
+  }
+  return inverse.lowBits(nbBits);
+}
+
+BigInt ParityVectorSolver::getBorderInput() const {
+  /**
+   * (3^k x + C) / 2^n is an integer: x = -C / 3^k modulo 2^n.
+   */
+  size_t n = parityVector.size();
+  BigInt toNegate =
+      (c.lowBits(n) * inverseModPowerOf2(powerOf3, n)).lowBits(n);
+  if (toNegate.isZero())
+    return toNegate;
+  return (BigInt(1) << n) - toNegate;
+}
+
+BigInt ParityVectorSolver::getBorderOutput() const {
+  size_t n = parityVector.size();
+  BigInt image = powerOf3 * getBorderInput() + c;
+  assert(image.lowBits(n).isZero());
+  return image >> n;
+}
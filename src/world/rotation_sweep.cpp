@@ -0,0 +1,154 @@
+/**
+ * Rotations of the parity vector of a border/cycle world computed
+ * concurrently, see `rotation_sweep.h`.
+ */
+
+#include "../rotation_sweep.h"
+
+#include <chrono>
+
+void simulateUntilResolved(World &world, int maxSteps,
+                           ParityVectorResult &result) {
+  world.setGraphicBufferEnabled(false);
+  auto start = std::chrono::steady_clock::now();
+  bool isCycle = world.inputType == CYCLE;
+  result.parityVector = world.inputStr;
+  result.isResolved =
+      isCycle ? world.isCycleDetected() : world.isComputationDone();
+  while (!result.isResolved && world.getNbSteps() < maxSteps) {
+    world.next();
+    result.isResolved =
+        isCycle ? world.isCycleDetected() : world.isComputationDone();
+  }
+
+  result.row.clear();
+  result.col.clear();
+  result.periodLength = -1;
+  if (result.isResolved) {
+    // Both are read least significant digit first
+    result.row = world.readRowOfBits();
+    std::reverse(result.row.begin(), result.row.end());
+    if (isCycle) {
+      std::pair<int, int> detectedCycle = world.getDetectedCycle();
+      result.periodLength = detectedCycle.second - detectedCycle.first;
+    } else {
+      result.col = world.readColumnOfSums();
+      std::reverse(result.col.begin(), result.col.end());
+    }
+  }
+  result.nbCells = world.cells.size();
+  result.nbSteps = world.getNbSteps();
+  result.timeMicroseconds =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+}
+
+RotationSweep::RotationSweep(World &world, int nbThreads, size_t cacheSize)
+    : baseWorld(world), baseInputStr(world.inputStr),
+      nbRotations(static_cast<int>(world.inputStr.size())),
+      currentRotation(0), cacheSize(MAX(cacheSize, 1)),
+      threadPool(new ThreadPool(MAX(nbThreads, 1))) {
+  assert(world.inputType == BORDER || world.inputType == CYCLE);
+}
+
+World &RotationSweep::getCurrentWorld() {
+  if (currentRotation == 0)
+    return baseWorld;
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto it = cacheIndex.find(currentRotation);
+  assert(it != cacheIndex.end());
+  cache.splice(cache.begin(), cache, it->second);
+  return *it->second->second;
+}
+
+World &RotationSweep::rotate(int direction) {
+  int nbSteps = getCurrentWorld().getNbSteps();
+  currentRotation =
+      ((currentRotation + direction) % nbRotations + nbRotations) %
+      nbRotations;
+  if (currentRotation == 0 || cacheIndex.count(currentRotation))
+    return getCurrentWorld();
+
+  /**
+   * The next rotations in the same direction are likely to be shown next:
+   * they are computed at the same time, up to the size of the cache.
+   */
+  std::vector<int> toCompute;
+  for (int iRotation = currentRotation;
+       toCompute.size() < cacheSize && iRotation != 0 &&
+       !cacheIndex.count(iRotation);
+       iRotation = ((iRotation + direction) % nbRotations + nbRotations) %
+                   nbRotations)
+    toCompute.push_back(iRotation);
+
+  std::vector<std::unique_ptr<World>> computed(toCompute.size());
+  threadPool->run(toCompute.size(), [&](int iTask) {
+    computed[iTask] = newWorld(toCompute[iTask]);
+    computed[iTask]->advance(nbSteps);
+  });
+  // The current rotation last so that it is the most recently used
+  for (size_t iTask = toCompute.size(); iTask > 0; iTask -= 1)
+    put(toCompute[iTask - 1], std::move(computed[iTask - 1]));
+  return getCurrentWorld();
+}
+
+std::vector<ParityVectorResult> RotationSweep::sweep(int maxSteps) {
+  /**
+   * Each task owns its world while it runs: cached worlds are taken out of
+   * the cache and put back once resolved.
+   */
+  std::vector<ParityVectorResult> results(nbRotations);
+  threadPool->run(nbRotations, [&](int rotation) {
+    std::unique_ptr<World> world;
+    World *toSimulate = &baseWorld;
+    if (rotation != 0) {
+      world = take(rotation);
+      if (!world)
+        world = newWorld(rotation);
+      toSimulate = world.get();
+    }
+    results[rotation].index = rotation;
+    simulateUntilResolved(*toSimulate, maxSteps, results[rotation]);
+    if (world)
+      put(rotation, std::move(world));
+  });
+  return results;
+}
+
+std::unique_ptr<World> RotationSweep::take(int rotation) {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto it = cacheIndex.find(rotation);
+  if (it == cacheIndex.end())
+    return std::unique_ptr<World>();
+  std::unique_ptr<World> world = std::move(it->second->second);
+  cache.erase(it->second);
+  cacheIndex.erase(it);
+  return world;
+}
+
+void RotationSweep::put(int rotation, std::unique_ptr<World> world) {
+  /**
+   * The world of the current rotation may be shown: it is never evicted.
+   */
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  cache.push_front(std::make_pair(rotation, std::move(world)));
+  cacheIndex[rotation] = cache.begin();
+  auto it = cache.end();
+  while (cache.size() > cacheSize && it != cache.begin()) {
+    --it;
+    if (it->first == currentRotation)
+      continue;
+    cacheIndex.erase(it->first);
+    it = cache.erase(it);
+  }
+}
+
+std::unique_ptr<World> RotationSweep::newWorld(int rotation) {
+  std::unique_ptr<World> world(new World(
+      baseWorld.isSequential(), baseWorld.inputType, baseInputStr,
+      baseWorld.constructCycleInLine, baseWorld.cycleBoth, false));
+  world->setProfiling(baseWorld.getProfile().isEnabled);
+  world->rotate(rotation);
+  return world;
+}
@@ -0,0 +1,184 @@
+/**
+ * Word level engine for LINE mode, see `row_engine.h`.
+ */
+
+#include "../row_engine.h"
+
+static int getBit(const std::vector<uint64_t> &words, int i) {
+  if (i < 0 || i >= 64 * static_cast<int>(words.size()))
+    return 0;
+  return (words[i / 64] >> (i % 64)) & 1;
+}
+
+static int countTrailingZeros(const std::vector<uint64_t> &words) {
+  int nbWords = static_cast<int>(words.size());
+  for (int iWord = 0; iWord < nbWords; iWord += 1)
+    if (words[iWord])
+      return 64 * iWord + __builtin_ctzll(words[iWord]);
+  return -1;
+}
+
+static void shiftRight(const std::vector<uint64_t> &words, int shift,
+                       std::vector<uint64_t> &toRet) {
+  int wordShift = shift / 64;
+  int bitShift = shift % 64;
+  int nbWords = static_cast<int>(words.size());
+  toRet.clear();
+  for (int iWord = wordShift; iWord < nbWords; iWord += 1) {
+    uint64_t word = words[iWord] >> bitShift;
+    if (bitShift && iWord + 1 < nbWords)
+      word |= words[iWord + 1] << (64 - bitShift);
+    toRet.push_back(word);
+  }
+  while (toRet.size() > 1 && toRet.back() == 0)
+    toRet.pop_back();
+}
+
+RowEngine::RowEngine(const std::string &inputRow) : nbRows(0) {
+  /**
+   * Row 0 holds the input, cells from x = -1 to x = -inputRow.size().
+   */
+  PackedRow row;
+  row.y = 0;
+  int n = static_cast<int>(inputRow.size());
+  std::vector<uint64_t> value(n / 64 + 1, 0);
+  for (int i = 0; i < n; i += 1)
+    if (inputRow[n - 1 - i] == '1')
+      value[i / 64] |= 1ULL << (i % 64);
+
+  int trailingZeros = countTrailingZeros(value);
+  if (trailingZeros == -1)
+    return; // Nothing happens on the null row
+
+  row.lastOneX = -1 - trailingZeros;
+  // The bootstrapping carry of an odd input sits at x = 0
+  row.eastX = MAX(-1, row.lastOneX + 1);
+  row.bits = value;
+  if (row.eastX == 0) {
+    row.bits.push_back(0);
+    for (int iWord = row.bits.size() - 1; iWord >= 0; iWord -= 1)
+      row.bits[iWord] =
+          (row.bits[iWord] << 1) | (iWord ? row.bits[iWord - 1] >> 63 : 0);
+  }
+  completeRow(row, -n);
+  rows.push_back(row);
+  nbRows = 1;
+}
+
+static void triplePlusOne(std::vector<uint64_t> &odd,
+                          std::vector<uint64_t> &sum,
+                          std::vector<uint64_t> &carries,
+                          std::vector<uint64_t> &carryIn) {
+  /**
+   * Computes `sum` = 3 * `odd` + 1 and the carries of the cells holding the
+   * bits of `odd`: bit i of `carries` is the carry going out of bit i.
+   */
+  odd.push_back(0);
+  int nbWords = odd.size();
+
+  // x + 2x + 1, the +1 is the bootstrapping carry
+  sum.assign(nbWords, 0);
+  carryIn.assign(nbWords, 0);
+  uint64_t carry = 1;
+  for (int iWord = 0; iWord < nbWords; iWord += 1) {
+    uint64_t a = odd[iWord];
+    uint64_t b = (a << 1) | (iWord ? odd[iWord - 1] >> 63 : 0);
+    uint64_t s = a + b;
+    uint64_t overflow = s < a;
+    s += carry;
+    overflow |= s < carry;
+    sum[iWord] = s;
+    carryIn[iWord] = s ^ a ^ b;
+    carry = overflow;
+  }
+
+  // The carry of a cell is the carry going into the cell west of it
+  carries.assign(nbWords, 0);
+  for (int iWord = 0; iWord < nbWords; iWord += 1)
+    carries[iWord] = (carryIn[iWord] >> 1) |
+                     (iWord + 1 < nbWords ? carryIn[iWord + 1] << 63 : 0);
+}
+
+void RowEngine::completeRow(PackedRow &row, int westStart) {
+  /**
+   * Computes the western extent of `row` and the value of the next row:
+   * 3x+1 where x is the odd part of `row`.
+   */
+  shiftRight(row.bits, row.eastX - row.lastOneX, odd);
+  triplePlusOne(odd, nextValue, carries, carryIn);
+
+  // As in the CA, the row grows west until a cell sums to 0
+  row.westX = westStart;
+  while (row.westX > row.lastOneX ||
+         getBit(odd, row.lastOneX - row.westX) +
+                 getBit(carries, row.lastOneX - row.westX) !=
+             0)
+    row.westX -= 1;
+}
+
+void RowEngine::next() {
+  /**
+   * The row is built in place at the back of `rows`: apart from its bits,
+   * nothing is allocated once the scratch buffers are big enough.
+   */
+  if (rows.empty())
+    return;
+  rows.emplace_back();
+  PackedRow &row = rows.back();
+  const PackedRow &last = rows[rows.size() - 2];
+  row.y = last.y + 1;
+  row.eastX = last.lastOneX;
+  row.bits.assign(nextValue.begin(), nextValue.end());
+  while (row.bits.size() > 1 && row.bits.back() == 0)
+    row.bits.pop_back();
+  row.lastOneX = row.eastX - countTrailingZeros(row.bits);
+  completeRow(row, last.westX);
+  nbRows += 1;
+}
+
+void RowEngine::advance(int nbSteps) {
+  for (int iStep = 0; iStep < nbSteps; iStep += 1)
+    next();
+}
+
+const PackedRow &RowEngine::getRow(int y) const {
+  assert(!rows.empty() && y >= rows.front().y && y <= rows.back().y);
+  return rows[y - rows.front().y];
+}
+
+std::string RowEngine::getRowString(int y) const {
+  const PackedRow &row = getRow(y);
+  std::string toRet;
+  for (int x = row.westX; x <= row.eastX; x += 1) {
+    char bit = '0' + getBit(row.bits, row.eastX - x);
+    if (toRet.empty() && bit == '0')
+      continue;
+    toRet.push_back(bit);
+  }
+  return toRet;
+}
+
+void RowEngine::materializeRow(
+    int y, std::vector<std::pair<Vector2i, Cell>> &out) const {
+  /**
+   * Produces the cells of row `y` as the CA would have computed them.
+   */
+  const PackedRow &row = getRow(y);
+  std::vector<uint64_t> odd, sum, carries, carryIn;
+  shiftRight(row.bits, row.eastX - row.lastOneX, odd);
+  triplePlusOne(odd, sum, carries, carryIn);
+  for (int x = row.eastX; x >= row.westX; x -= 1) {
+    Cell cell(ZERO, ZERO);
+    if (x == row.lastOneX + 1)
+      cell = Cell(ZERO, ONE, true);
+    else if (x <= row.lastOneX)
+      cell = Cell(static_cast<AtomicInfo>(getBit(odd, row.lastOneX - x)),
+                  static_cast<AtomicInfo>(getBit(carries, row.lastOneX - x)));
+    out.push_back(std::make_pair(Vector2i(x, y), cell));
+  }
+}
+
+void RowEngine::forgetRowsBefore(int y) {
+  while (rows.size() > 1 && rows.front().y < y)
+    rows.pop_front();
+}
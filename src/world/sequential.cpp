@@ -0,0 +1,140 @@
+/**
+ * Sequential simulation of the world: instead of sweeping the whole edge at
+ * each step, cells are processed one at a time from a worklist and only the
+ * cells whose rules read an updated cell are enqueued again.
+ */
+
+#include "../world.h"
+
+void World::seedWorklist() {
+  /**
+   * Initially, every cell of the input may be ready. In LINE/COL mode the
+   * edge is not tracked, they are the cells waiting to be drawn.
+   */
+  assert(isSequentialSim);
+  worklist.clear();
+  queuedCells.clear();
+  if (inputType == LINE || inputType == COL) {
+    for (const Vector2i &cellPos : cellGraphicBuffer)
+      enqueue(cellPos);
+    cellsOnEdge.clear();
+    for (const Vector2i &cellPos : worklist)
+      cellsOnEdge.insert(cellPos);
+  } else {
+    for (const Vector2i &cellPos : cellsOnEdge)
+      enqueue(cellPos);
+  }
+}
+
+void World::enqueue(const Vector2i &cellPos) {
+  if (!isSequentialCandidate(cellPos))
+    return;
+  if (queuedCells.insert(cellPos).second)
+    worklist.push_back(cellPos);
+}
+
+void World::nextSequential() {
+  /**
+   * Processes the cells which were in the worklist when the step started,
+   * the cells they enqueue are processed at next step. In LINE/COL mode, the
+   * cells left in the worklist are the edge.
+   */
+  PROFILE_PHASE(PHASE_SEQUENTIAL);
+  size_t nbCellsToProcess = worklist.size();
+  PROFILE_UPDATES(PHASE_SEQUENTIAL, nbCellsToProcess);
+  for (size_t iCell = 0; iCell < nbCellsToProcess; iCell += 1) {
+    Vector2i cellPos = worklist.front();
+    worklist.pop_front();
+    queuedCells.erase(cellPos);
+    processCell(cellPos);
+  }
+
+  if (inputType == LINE || inputType == COL) {
+    cellsOnEdge.clear();
+    for (const Vector2i &cellPos : worklist)
+      cellsOnEdge.insert(cellPos);
+  }
+}
+
+bool World::isSequentialCandidate(const Vector2i &cellPos) {
+  /**
+   * In LINE/COL mode the edge leaves out the trailing 0s of a row, waiting
+   * for the bootstrapping carry. That relies on the CA timing: processed one
+   * at a time, a trailing 0 may still have a carry to receive from its
+   * defined east neighbour. Any half defined cell is then a candidate.
+   */
+  if (inputType == LINE || inputType == COL)
+    return doesCellExists(cellPos) &&
+           cells[cellPos].getStatus() == HALF_DEFINED;
+  return cellsOnEdge.find(cellPos) != cellsOnEdge.end();
+}
+
+void World::processCell(const Vector2i &cellPos) {
+  /**
+   * Applies the rules of the CA to a single cell, in the same order as a CA
+   * step: non local rule first, then the local rule.
+   */
+  if (!isSequentialCandidate(cellPos))
+    return;
+
+  // In the CA a half defined cell whose east neighbour is defined always
+  // gets its carry before a bootstrapping carry could overwrite it
+  Vector2i eastPos = cellPos + EAST;
+  bool isCarryPending = doesCellExists(eastPos) &&
+                        cells[eastPos].getStatus() == HALF_DEFINED &&
+                        doesCellExists(eastPos + EAST) &&
+                        cells[eastPos + EAST].getStatus() == DEFINED;
+  sequentialUpdates.clear();
+  if (!isCarryPending)
+    findNonLocalUpdate(cellPos, sequentialUpdates);
+  applySequentialUpdates(sequentialUpdates);
+
+  if (!isSequentialCandidate(cellPos))
+    return;
+  sequentialUpdates.clear();
+  findCarryPropUpdate(cellPos, sequentialUpdates);
+  if (inputType == LINE || inputType == COL)
+    findForwardDeductionUpdate(cellPos, sequentialUpdates);
+  else
+    findBackwardDeductionUpdate(cellPos, sequentialUpdates);
+  applySequentialUpdates(sequentialUpdates);
+}
+
+void World::applySequentialUpdates(
+    const std::vector<CellPosAndCell> &updates) {
+  if (updates.empty())
+    return;
+  applyAndEnqueue(updates);
+  if (inputType == CYCLE)
+    applyAndEnqueue(findCyclicUpdates(updates));
+}
+
+void World::applyAndEnqueue(const std::vector<CellPosAndCell> &updates) {
+  /**
+   * Applies `updates` and enqueues the cells whose rules read them: carry
+   * propagation and forward deduction read the cell east, backward deduction
+   * the cell north east and the non local rule the bits east on the row.
+   */
+  erasedOnes.clear();
+  for (const auto &info : updates)
+    if (doesCellExists(info.first) && cells[info.first].bit == ONE &&
+        info.second.bit != ONE)
+      erasedOnes.push_back(info.first);
+
+  applyUpdates(updates);
+
+  for (const auto &info : updates) {
+    enqueue(info.first);
+    enqueue(info.first + WEST);
+    if (inputType == BORDER || inputType == CYCLE)
+      enqueue(info.first + SOUTH + WEST);
+  }
+
+  // A ONE bit west of an erased one may have become the last one of its row
+  for (const Vector2i &erasedPos : erasedOnes) {
+    Vector2i cellPos = erasedPos + WEST;
+    while (doesCellExists(cellPos) && cells[cellPos].bit != ONE)
+      cellPos += WEST;
+    enqueue(cellPos);
+  }
+}
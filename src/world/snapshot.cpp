@@ -0,0 +1,344 @@
+/**
+ * Binary snapshots of the world. A snapshot is a header followed by raw
+ * arrays, each starting on an 8 bytes boundary: the file is mapped in
+ * memory and tiles are copied as they are, cells are not parsed one by one.
+ * Numbers are stored in the byte order of the machine which wrote them, the
+ * header records it.
+ */
+
+#include "../world.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = "SIMCQCA";
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  int32_t inputType;
+  uint8_t isSequentialSim, constructCycleInLine, cycleBoth, alreadyTweaked;
+  int32_t cyclicForwardVector[2];
+  int32_t indexesDetectedCycle[2];
+  // Sizes of the arrays following the header, in that order
+  uint64_t inputStrSize;
+  uint64_t nbTiles;
+  uint64_t nbEdgeCells;
+  uint64_t nbParityVectorCells;
+  uint64_t nbWorklistCells;
+  uint64_t nbRowSummaries;
+  uint64_t nbColSummaries;
+  uint64_t nbCycleDetectionLayers; // Their cuts are hashed again on load
+  int64_t nbSteps;
+};
+
+struct SnapshotTile {
+  uint64_t key;
+  uint64_t nbCells;
+  uint8_t packed[TILE_SIDE * TILE_SIDE / 2];
+};
+
+struct SnapshotPos {
+  int32_t x, y;
+};
+
+struct SnapshotSummary {
+  int32_t key; // y of a row, x of a column
+  int32_t min, max, nbCells, extremal;
+};
+
+class SnapshotWriter {
+public:
+  SnapshotWriter(FILE *file) : isOk(true), file(file) {}
+  template <typename T> void write(const T *data, size_t count) {
+    /**
+     * Writes an array, padded to the next 8 bytes boundary.
+     */
+    static const char padding[8] = {0};
+    size_t size = count * sizeof(T);
+    if (size != 0)
+      isOk &= (fwrite(data, 1, size, file) == size);
+    if (size % 8 != 0)
+      isOk &= (fwrite(padding, 1, 8 - size % 8, file) == 8 - size % 8);
+  }
+  bool isOk;
+
+private:
+  FILE *file;
+};
+
+class SnapshotReader {
+public:
+  SnapshotReader(const std::string &path) : path(path), data(NULL), size(0) {
+    /**
+     * Maps the whole file in memory.
+     */
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (fd < 0 || fstat(fd, &fileStat) != 0) {
+      printf("Could not open snapshot `%s`. Abort.\n", path.c_str());
+      exit(0);
+    }
+    size = fileStat.st_size;
+    if (size != 0) {
+      void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        printf("Could not map snapshot `%s`. Abort.\n", path.c_str());
+        exit(0);
+      }
+      data = static_cast<const char *>(mapped);
+    }
+    close(fd);
+#else
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == NULL) {
+      printf("Could not open snapshot `%s`. Abort.\n", path.c_str());
+      exit(0);
+    }
+    char chunk[1 << 16];
+    size_t nbRead;
+    while ((nbRead = fread(chunk, 1, sizeof(chunk), file)) != 0)
+      buffer.insert(buffer.end(), chunk, chunk + nbRead);
+    fclose(file);
+    data = buffer.data();
+    size = buffer.size();
+#endif
+    offset = 0;
+  }
+  ~SnapshotReader() {
+#ifndef _WIN32
+    if (data)
+      munmap(const_cast<char *>(data), size);
+#endif
+  }
+
+  template <typename T> const T *read(size_t count) {
+    /**
+     * Returns the next array of the file, in place.
+     */
+    size_t arraySize = count * sizeof(T);
+    if (count > size || arraySize > size - offset)
+      abortCorrupted();
+    const T *array = reinterpret_cast<const T *>(data + offset);
+    offset += (arraySize + 7) / 8 * 8;
+    offset = MIN(offset, size);
+    return array;
+  }
+
+  const SnapshotHeader &readHeader() {
+    const SnapshotHeader &header = *read<SnapshotHeader>(1);
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+      abortCorrupted();
+    if (header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+      printf("Snapshot `%s` was written on a machine with another byte "
+             "order. Abort.\n",
+             path.c_str());
+      exit(0);
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+      printf("Snapshot `%s` has version %d, this simulator reads version %d. "
+             "Abort.\n",
+             path.c_str(), header.version, SNAPSHOT_VERSION);
+      exit(0);
+    }
+    if (header.inputType < LINE || header.inputType > CYCLE)
+      abortCorrupted();
+    return header;
+  }
+
+private:
+  void abortCorrupted() {
+    printf("Snapshot `%s` is not a valid snapshot. Abort.\n", path.c_str());
+    exit(0);
+  }
+
+  std::string path;
+  const char *data;
+  size_t size;
+  size_t offset;
+#ifdef _WIN32
+  std::vector<char> buffer;
+#endif
+};
+
+template <typename Container>
+static void writePositions(SnapshotWriter &writer, const Container &toWrite) {
+  std::vector<SnapshotPos> positions;
+  for (const Vector2i &cellPos : toWrite)
+    positions.push_back({cellPos.x, cellPos.y});
+  writer.write(positions.data(), positions.size());
+}
+
+void World::saveSnapshot(const std::string &path) {
+  if (isFastEngineEnabled) {
+    printf("Snapshots are not available with the fast engines.\n");
+    return;
+  }
+  FILE *file = fopen(path.c_str(), "wb");
+  if (file == NULL) {
+    printf("Could not save snapshot to `%s`.\n", path.c_str());
+    return;
+  }
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  header.version = SNAPSHOT_VERSION;
+  header.byteOrder = SNAPSHOT_BYTE_ORDER;
+  header.inputType = inputType;
+  header.isSequentialSim = isSequentialSim;
+  header.constructCycleInLine = constructCycleInLine;
+  header.cycleBoth = cycleBoth;
+  header.alreadyTweaked = alreadyTweaked;
+  header.cyclicForwardVector[0] = cyclicForwardVector.x;
+  header.cyclicForwardVector[1] = cyclicForwardVector.y;
+  header.indexesDetectedCycle[0] = indexesDetectedCycle.first;
+  header.indexesDetectedCycle[1] = indexesDetectedCycle.second;
+  header.inputStrSize = inputStr.size();
+  header.nbTiles = cells.getNbTiles();
+  header.nbEdgeCells = cellsOnEdge.size();
+  header.nbParityVectorCells = parityVectorCells.size();
+  header.nbWorklistCells = worklist.size();
+  header.nbRowSummaries = rowSummaries.size();
+  header.nbColSummaries = colSummaries.size();
+  header.nbCycleDetectionLayers = cycleDetectionHashes.size();
+  header.nbSteps = nbSteps;
+
+  SnapshotWriter writer(file);
+  writer.write(&header, 1);
+  writer.write(inputStr.data(), inputStr.size());
+
+  SnapshotTile snapshotTile;
+  cells.forEachTile([&](uint64_t key, const Tile &tile) {
+    snapshotTile.key = key;
+    snapshotTile.nbCells = CellStore::countCells(tile);
+    memcpy(snapshotTile.packed, tile.packed, sizeof(tile.packed));
+    writer.write(&snapshotTile, 1);
+  });
+
+  writePositions(writer, cellsOnEdge);
+  writePositions(writer, parityVectorCells);
+  writePositions(writer, worklist);
+
+  std::vector<SnapshotSummary> summaries;
+  for (const auto &row : rowSummaries)
+    summaries.push_back({row.first, row.second.minX, row.second.maxX,
+                         row.second.nbCells, row.second.rightmostOne});
+  writer.write(summaries.data(), summaries.size());
+  summaries.clear();
+  for (const auto &col : colSummaries)
+    summaries.push_back({col.first, col.second.minY, col.second.maxY,
+                         col.second.nbCells, col.second.topmostNonZero});
+  writer.write(summaries.data(), summaries.size());
+
+  bool isOk = writer.isOk;
+  isOk &= (fclose(file) == 0);
+  if (!isOk) {
+    printf("Could not save snapshot to `%s`.\n", path.c_str());
+    return;
+  }
+  printf("Written snapshot of %ld cells to `%s`.\n", cells.size(),
+         path.c_str());
+}
+
+void World::readSnapshotInput(const std::string &path, Arguments &arguments) {
+  /**
+   * Fills the input arguments with the ones the snapshot was taken with.
+   */
+  SnapshotReader reader(path);
+  const SnapshotHeader &header = reader.readHeader();
+  const char *input = reader.read<char>(header.inputStrSize);
+  arguments.inputType = static_cast<InputType>(header.inputType);
+  arguments.inputStr = std::string(input, header.inputStrSize);
+  arguments.isSequential = header.isSequentialSim;
+  arguments.constructCycleInLine = header.constructCycleInLine;
+  arguments.cycleBoth = header.cycleBoth;
+}
+
+void World::loadSnapshot(const std::string &path) {
+  /**
+   * The world must have been built from the input of the snapshot, see
+   * `readSnapshotInput`. The fast engines only take its input.
+   */
+  if (isFastEngineEnabled) {
+    printf("Snapshots are not available with the fast engines, only the "
+           "input of `%s` is used.\n",
+           path.c_str());
+    return;
+  }
+  SnapshotReader reader(path);
+  const SnapshotHeader &header = reader.readHeader();
+  const char *input = reader.read<char>(header.inputStrSize);
+  assert(header.inputType == inputType &&
+         inputStr == std::string(input, header.inputStrSize));
+
+  cells.clear();
+  cellsOnEdge.clear();
+  edgeCandidates.clear();
+  isFullEdgeCleanNeeded = false;
+  rowSummaries.clear();
+  colSummaries.clear();
+  cellGraphicBuffer.clear();
+  parityVectorCells.clear();
+  worklist.clear();
+  queuedCells.clear();
+
+  nbSteps = header.nbSteps;
+  alreadyTweaked = header.alreadyTweaked;
+  cyclicForwardVector = {header.cyclicForwardVector[0],
+                         header.cyclicForwardVector[1]};
+  indexesDetectedCycle = std::make_pair(header.indexesDetectedCycle[0],
+                                        header.indexesDetectedCycle[1]);
+
+  const SnapshotTile *tiles = reader.read<SnapshotTile>(header.nbTiles);
+  for (size_t iTile = 0; iTile < header.nbTiles; iTile += 1)
+    cells.restoreTile(tiles[iTile].key, tiles[iTile].packed,
+                      tiles[iTile].nbCells);
+
+  const SnapshotPos *positions = reader.read<SnapshotPos>(header.nbEdgeCells);
+  for (size_t i = 0; i < header.nbEdgeCells; i += 1)
+    cellsOnEdge.insert({positions[i].x, positions[i].y});
+  positions = reader.read<SnapshotPos>(header.nbParityVectorCells);
+  for (size_t i = 0; i < header.nbParityVectorCells; i += 1)
+    parityVectorCells.push_back({positions[i].x, positions[i].y});
+  positions = reader.read<SnapshotPos>(header.nbWorklistCells);
+  for (size_t i = 0; i < header.nbWorklistCells; i += 1) {
+    worklist.push_back({positions[i].x, positions[i].y});
+    queuedCells.insert(worklist.back());
+  }
+
+  const SnapshotSummary *summaries =
+      reader.read<SnapshotSummary>(header.nbRowSummaries);
+  for (size_t i = 0; i < header.nbRowSummaries; i += 1) {
+    RowSummary &row = rowSummaries[summaries[i].key];
+    row.minX = summaries[i].min;
+    row.maxX = summaries[i].max;
+    row.nbCells = summaries[i].nbCells;
+    row.rightmostOne = summaries[i].extremal;
+  }
+  summaries = reader.read<SnapshotSummary>(header.nbColSummaries);
+  for (size_t i = 0; i < header.nbColSummaries; i += 1) {
+    ColSummary &col = colSummaries[summaries[i].key];
+    col.minY = summaries[i].min;
+    col.maxY = summaries[i].max;
+    col.nbCells = summaries[i].nbCells;
+    col.topmostNonZero = summaries[i].extremal;
+  }
+
+  if (inputType == CYCLE)
+    restoreCycleDetection(header.nbCycleDetectionLayers);
+
+  redraw();
+  nbTilesAfterEviction = cells.getNbTiles();
+  printf("Loaded snapshot of %ld cells from `%s`.\n", cells.size(),
+         path.c_str());
+}
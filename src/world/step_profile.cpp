@@ -0,0 +1,80 @@
+/**
+ * Per phase timing and counters of the simulation steps, see
+ * `step_profile.h`.
+ */
+
+#include "../step_profile.h"
+
+#include <algorithm>
+#include <cstdio>
+
+static const char *PHASE_NAMES[NB_STEP_PHASES] = {
+    "other",
+    "non local rule",
+    "carry propagation",
+    "forward deduction",
+    "backward deduction",
+    "cyclic updates",
+    "apply updates",
+    "clean edge",
+    "sequential worklist",
+    "fast engine",
+    "streaming eviction",
+    "macro blocks"};
+
+void StepProfile::clear() {
+  std::fill(nanoseconds, nanoseconds + NB_STEP_PHASES, 0);
+  std::fill(nbCalls, nbCalls + NB_STEP_PHASES, 0);
+  std::fill(nbUpdates, nbUpdates + NB_STEP_PHASES, 0);
+  nbSteps = 0;
+  edgeSize = peakEdgeSize = 0;
+  totalEdgeSize = 0;
+  nbCells = peakNbCells = 0;
+  activePhase = NO_PHASE;
+}
+
+void StepProfile::endSteps(int nbEndedSteps, size_t edgeSize,
+                           size_t nbCells) {
+  if (!isEnabled)
+    return;
+  nbSteps += nbEndedSteps;
+  this->edgeSize = edgeSize;
+  peakEdgeSize = std::max(peakEdgeSize, edgeSize);
+  totalEdgeSize += static_cast<uint64_t>(nbEndedSteps) * edgeSize;
+  this->nbCells = nbCells;
+  peakNbCells = std::max(peakNbCells, nbCells);
+}
+
+void StepProfile::print() const {
+  if (!IS_PROFILING_COMPILED) {
+    printf("Profiling: not compiled in, build with SIMCQCA_PROFILING\n");
+    return;
+  }
+  if (!isEnabled) {
+    printf("Profiling: disabled\n");
+    return;
+  }
+  uint64_t totalNanoseconds = 0;
+  for (int iPhase = 0; iPhase < NB_STEP_PHASES; iPhase += 1)
+    totalNanoseconds += nanoseconds[iPhase];
+  printf("Profile of %llu steps, %.3f ms:\n",
+         static_cast<unsigned long long>(nbSteps), totalNanoseconds / 1e6);
+  printf("  %-20s %12s %7s %10s %12s\n", "phase", "time (ms)", "share",
+         "calls", "updates");
+  for (int iPhase = 0; iPhase < NB_STEP_PHASES; iPhase += 1) {
+    if (nbCalls[iPhase] == 0)
+      continue;
+    double share =
+        100.0 * nanoseconds[iPhase] / std::max<uint64_t>(totalNanoseconds, 1);
+    printf("  %-20s %12.3f %6.1f%% %10llu %12llu\n", PHASE_NAMES[iPhase],
+           nanoseconds[iPhase] / 1e6, share,
+           static_cast<unsigned long long>(nbCalls[iPhase]),
+           static_cast<unsigned long long>(nbUpdates[iPhase]));
+  }
+  if (nbSteps == 0)
+    return;
+  printf("  Edge: %zu cells at last step, %zu at most, %.1f on average\n",
+         edgeSize, peakEdgeSize, static_cast<double>(totalEdgeSize) / nbSteps);
+  if (peakNbCells != 0) // Not written yet by the fast engines
+    printf("  Cells: %zu at last step, %zu at most\n", nbCells, peakNbCells);
+}
@@ -0,0 +1,111 @@
+/**
+ * Streaming mode: the world only keeps the cells around the edge of the
+ * computation so that memory stays bounded on long runs.
+ * The rules read cells at most one cell away from the edge, apart from the
+ * row and column summaries which are kept. The edge only moves forward, so
+ * fully defined tiles far behind it are never read again.
+ */
+
+#include "../world.h"
+
+World::~World() {
+  if (spillFile)
+    fclose(spillFile);
+}
+
+void World::setStreaming(int margin) {
+  /**
+   * `margin` is in cells, -1 disables streaming.
+   */
+  if (inputType == CYCLE && margin >= 0) {
+    printf("Streaming is not available in cycle mode. Abort.\n");
+    exit(0);
+  }
+  streamingMargin = (margin < 0) ? -1 : MAX(margin, MIN_STREAMING_MARGIN);
+  nbTilesAfterEviction = cells.getNbTiles();
+}
+
+void World::addEvictionCallback(const EvictionCallback &callback) {
+  evictionCallbacks.push_back(callback);
+}
+
+void World::spillEvictedCellsTo(const std::string &path) {
+  assert(spillFile == NULL);
+  spillFile = fopen(path.c_str(), "w");
+  if (spillFile == NULL) {
+    printf("Could not open `%s` to spill evicted cells. Abort.\n",
+           path.c_str());
+    exit(0);
+  }
+  FILE *file = spillFile;
+  addEvictionCallback([file](const Vector2i &cellPos, const Cell &cell) {
+    fprintf(file, "%d %d %d %d\n", cellPos.x, cellPos.y,
+            static_cast<int>(cell.bit), static_cast<int>(cell.carry));
+  });
+}
+
+void World::evictFarCellsIfNeeded() {
+  /**
+   * Evicting scans every tile: it only happens once the number of tiles
+   * has doubled since the last eviction, the cost is amortized.
+   */
+  assert(isStreaming());
+  size_t nbTiles = cells.getNbTiles();
+  if (nbTiles < 2 * nbTilesAfterEviction ||
+      nbTiles < nbTilesAfterEviction + MIN_NEW_TILES_BETWEEN_EVICTIONS)
+    return;
+  evictFarCells();
+  nbTilesAfterEviction = cells.getNbTiles();
+}
+
+void World::evictFarCells() {
+  PROFILE_PHASE(PHASE_EVICTION);
+  TileKeySet keptTiles;
+  int minY = INT_MAX, maxY = INT_MIN, minX = INT_MAX, maxX = INT_MIN;
+  auto keepAround = [&](const Vector2i &cellPos) {
+    int margin = streamingMargin;
+    for (int tileY = (cellPos.y - margin) >> TILE_SHIFT;
+         tileY <= (cellPos.y + margin) >> TILE_SHIFT; tileY += 1)
+      for (int tileX = (cellPos.x - margin) >> TILE_SHIFT;
+           tileX <= (cellPos.x + margin) >> TILE_SHIFT; tileX += 1)
+        keptTiles.insert(
+            CellStore::tileKey({tileX * TILE_SIDE, tileY * TILE_SIDE}));
+    minY = MIN(minY, cellPos.y - margin);
+    maxY = MAX(maxY, cellPos.y + margin);
+    minX = MIN(minX, cellPos.x - margin);
+    maxX = MAX(maxX, cellPos.x + margin);
+  };
+  for (const Vector2i &cellPos : cellsOnEdge)
+    keepAround(cellPos);
+  // Read by `isComputationDone`
+  if (inputType == BORDER)
+    keepAround({-1 * static_cast<int>(inputStr.length()) + 1, 0});
+
+  size_t nbEvicted = cells.evictDefinedTiles(
+      keptTiles, [this](const Vector2i &cellPos, const Cell &cell) {
+        for (const EvictionCallback &callback : evictionCallbacks)
+          callback(cellPos, cell);
+      });
+  nbEvictedCells += nbEvicted;
+  PROFILE_UPDATES(PHASE_EVICTION, nbEvicted);
+
+  // Evicted cells are not drawn
+  cellGraphicBuffer.erase(
+      std::remove_if(cellGraphicBuffer.begin(), cellGraphicBuffer.end(),
+                     [this](const Vector2i &cellPos) {
+                       return !doesCellExists(cellPos);
+                     }),
+      cellGraphicBuffer.end());
+
+  // Rows and columns away from the edge will not be written anymore
+  for (auto it = rowSummaries.begin(); it != rowSummaries.end();)
+    if (it->first < minY || it->first > maxY)
+      it = rowSummaries.erase(it);
+    else
+      ++it;
+  for (auto it = colSummaries.begin(); it != colSummaries.end();)
+    if (it->first < minX || it->first > maxX)
+      it = colSummaries.erase(it);
+    else
+      ++it;
+}
@@ -0,0 +1,63 @@
+/**
+ * Thread pool used to find the updates of a simulation step in parallel,
+ * see `thread_pool.h`.
+ */
+
+#include "../thread_pool.h"
+
+ThreadPool::ThreadPool(int nbThreads)
+    : nbThreads(nbThreads), task(NULL), nbTasks(0), nextTask(0),
+      nbTasksDone(0), isStopping(false) {
+  for (int iWorker = 1; iWorker < nbThreads; iWorker += 1)
+    workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    isStopping = true;
+  }
+  isTaskReady.notify_all();
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+void ThreadPool::run(int nbTasks, const std::function<void(int)> &task) {
+  std::unique_lock<std::mutex> lock(mutex);
+  this->task = &task;
+  this->nbTasks = nbTasks;
+  nextTask = 0;
+  nbTasksDone = 0;
+  isTaskReady.notify_all();
+
+  while (nextTask < nbTasks) {
+    int iTask = nextTask;
+    nextTask += 1;
+    lock.unlock();
+    task(iTask);
+    lock.lock();
+    nbTasksDone += 1;
+  }
+  isBatchDone.wait(lock, [this] { return nbTasksDone == this->nbTasks; });
+  this->task = NULL;
+}
+
+void ThreadPool::work() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    isTaskReady.wait(lock, [this] {
+      return isStopping || (task != NULL && nextTask < nbTasks);
+    });
+    if (isStopping)
+      return;
+    const std::function<void(int)> &currentTask = *task;
+    int iTask = nextTask;
+    nextTask += 1;
+    lock.unlock();
+    currentTask(iTask);
+    lock.lock();
+    nbTasksDone += 1;
+    if (nbTasksDone == nbTasks)
+      isBatchDone.notify_one();
+  }
+}
@@ -0,0 +1,144 @@
+/**
+ * Out-of-core storage of tiles in a memory mapped file, see `cell_store.h`.
+ * The file is a scratch file: it is unlinked as soon as it is opened and
+ * disappears with the process.
+ */
+
+#include "../cell_store.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+// Address space reserved for the mapping, pages are only backed by the file
+// once it has grown over them
+static const size_t NB_RESERVED_BYTES = static_cast<size_t>(1) << 40;
+static const size_t CHUNK_SIZE = TILES_PER_CHUNK * sizeof(Tile);
+
+#ifdef _WIN32
+
+TileArena::TileArena(const std::string &path, size_t residentBudget) {
+  printf("Out-of-core cells are not available on Windows. Abort.\n");
+  exit(0);
+}
+
+TileArena::~TileArena() {}
+Tile *TileArena::allocate() { return NULL; }
+void TileArena::release(Tile *tile) {}
+void TileArena::clear() {}
+void TileArena::markReferenced(size_t iChunk) {}
+void TileArena::pageOut() {}
+
+#else
+
+TileArena::TileArena(const std::string &path, size_t residentBudget)
+    : nbFileTiles(0), nbUsedTiles(0), nbResidentChunks(0), clockHand(0) {
+  assert(CHUNK_SIZE % sysconf(_SC_PAGESIZE) == 0);
+  fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0) {
+    printf("Could not open `%s` to store cells. Abort.\n", path.c_str());
+    exit(0);
+  }
+  unlink(path.c_str());
+
+  void *mapping = mmap(NULL, NB_RESERVED_BYTES, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    printf("Could not map `%s` in memory. Abort.\n", path.c_str());
+    exit(0);
+  }
+  base = static_cast<Tile *>(mapping);
+  nbReservedTiles = NB_RESERVED_BYTES / sizeof(Tile);
+  nbBudgetChunks = MAX(residentBudget / CHUNK_SIZE, 1);
+}
+
+TileArena::~TileArena() {
+  munmap(base, NB_RESERVED_BYTES);
+  close(fd);
+}
+
+Tile *TileArena::allocate() {
+  Tile *tile;
+  if (!freeTiles.empty()) {
+    tile = freeTiles.back();
+    freeTiles.pop_back();
+  } else {
+    if (nbUsedTiles == nbFileTiles) {
+      // The file is sparse: doubling its size does not use disk space
+      size_t nbNewFileTiles = MAX(2 * nbFileTiles, TILES_PER_CHUNK);
+      if (nbNewFileTiles > nbReservedTiles ||
+          ftruncate(fd, nbNewFileTiles * sizeof(Tile)) != 0) {
+        printf("Could not grow the out-of-core cell file. Abort.\n");
+        exit(0);
+      }
+      nbFileTiles = nbNewFileTiles;
+      isResident.resize(nbFileTiles / TILES_PER_CHUNK, 0);
+      isReferenced.resize(nbFileTiles / TILES_PER_CHUNK, 0);
+    }
+    tile = base + nbUsedTiles;
+    nbUsedTiles += 1;
+  }
+  touch(tile);
+  return new (tile) Tile();
+}
+
+void TileArena::release(Tile *tile) { freeTiles.push_back(tile); }
+
+void TileArena::clear() {
+  /**
+   * Truncating the file frees its pages, resident or not.
+   */
+  if (ftruncate(fd, 0) != 0) {
+    printf("Could not truncate the out-of-core cell file. Abort.\n");
+    exit(0);
+  }
+  nbFileTiles = 0;
+  nbUsedTiles = 0;
+  freeTiles.clear();
+  isResident.clear();
+  isReferenced.clear();
+  nbResidentChunks = 0;
+  clockHand = 0;
+}
+
+void TileArena::markReferenced(size_t iChunk) {
+  if (!isResident[iChunk]) {
+    if (nbResidentChunks >= nbBudgetChunks)
+      pageOut();
+    isResident[iChunk] = 1;
+    nbResidentChunks += 1;
+  }
+  isReferenced[iChunk] = 1;
+}
+
+void TileArena::pageOut() {
+  /**
+   * Second chance: a chunk written to since the hand last passed is spared
+   * once. Pages out down to 3/4 of the budget so that sweeps are amortized.
+   * Dirty pages go back to the file, nothing is lost.
+   */
+  size_t nbChunks = isResident.size();
+  size_t nbTargetChunks = nbBudgetChunks * 3 / 4;
+  for (size_t iStep = 0; iStep < 2 * nbChunks; iStep += 1) {
+    if (nbResidentChunks <= nbTargetChunks)
+      break;
+    size_t iChunk = clockHand;
+    clockHand = (clockHand + 1) % nbChunks;
+    if (!isResident[iChunk])
+      continue;
+    if (isReferenced[iChunk]) {
+      isReferenced[iChunk] = 0;
+      continue;
+    }
+    madvise(base + iChunk * TILES_PER_CHUNK, CHUNK_SIZE, MADV_DONTNEED);
+    isResident[iChunk] = 0;
+    nbResidentChunks -= 1;
+  }
+}
+
+#endif